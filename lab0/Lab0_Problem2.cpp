@@ -1,45 +1,84 @@
 /*
 Author: Kamya Hari
 Class: ECE 6122
-Last Date Modified: 09-03-2024
+Last Date Modified: 10-18-2026
 
 Description:
 
 This program takes in any natural number and outputs the sum of primes less than or equal to the number.
+The primes are found with a segmented, odd-only Sieve of Eratosthenes with a 2 * 3 * 5 * 7 wheel (primeSieve.h),
+so the work grows like n log log n instead of the n^2 of testing every divisor of every number.
+The sieve is kept between queries (primeSumCache.h) together with the sum of the primes below every 128 integers, so
+a number up to the largest one sieved so far is answered in O(1), and a larger one only sieves the numbers that are new.
+Above CACHE_LIMIT, the sum is computed instead with Lucy_Hedgehog's O(n^(3/4)) method (lucyPrimeSum.h), which needs
+neither a sieve up to n nor more than O(sqrt(n)) memory and accumulates in 128 bits; its answers are kept as well.
+Run as Lab0_Problem2 [-t <threads>]: the sieve or the Lucy method are split over the given number of threads (0 = all
+hardware threads).
+Lab0_Problem2 --build-table N [--table <file>] writes the prime sums up to N to a table file (primeTable.h) and exits;
+Lab0_Problem2 --table <file> maps that file and answers every number up to its N with a lookup and a short scan.
+Lab0_Problem2 --batch <file> reads whitespace-separated numbers from the file (- for stdin) and prints the sum for each,
+one per line in the same order, from a single sieve sweep over all of them (primeBatch.h).
+Inputs are read as 64-bit numbers and accepted up to MAX_INPUT; sums are 128-bit and printed in decimal.
 */
 
 #include <iostream>
 #include<limits>
 #include<cctype>
 #include<string>
+#include<cstring>
+#include<cstdlib>
+#include<algorithm>
+#include<map>
+#include<fstream>
+#include<vector>
+#include "primeSieve.h"
+#include "primeSumCache.h"
+#include "primeTable.h"
+#include "lucyPrimeSum.h"
+#include "primeBatch.h"
 
-int numberIsAPrime(int givenNumber) // This function checks if a given number is a prime number - input is the given integer - returns 0 if the number is not prime, 1 if the number is prime
+const std::uint64_t MAX_INPUT = 100000000000000ULL; //10^14: the Lucy method then needs about 160 MB and 30 s on one core
+const char* DEFAULT_TABLE_FILE = "primeSums.table"; //written by --build-table when --table is not given
+const std::uint64_t CACHE_LIMIT = std::uint64_t(1) << 28; //the kept sieve grows up to here (32 MiB, 0.3 s to sieve on one core); larger numbers use the Lucy method
+
+struct QueryCache //what earlier queries of this run computed, and the table file if one is mapped
+{
+	PrimeTable table; //answers up to its N (--table)
+	PrimeSumCache sieve{ CACHE_LIMIT };
+	std::map<std::uint64_t, unsigned __int128> lucySums; //answers above CACHE_LIMIT
+};
+
+unsigned __int128 sumOfPrimes(QueryCache& cache, std::uint64_t givenNumber, int numThreads) //This function computes the sum of all the preceding prime numbers to the given number -inputs are the cache of earlier queries, the given number and the number of threads - the output is the sum of all primes up to the given number, from the kept sieve or the Lucy method
 {
 	if (givenNumber < 2) //Prime numbers start from 2
 	{
 		return 0;
 	}
-	for (int i = 2; i < givenNumber; i++) // This for loop iterates over the preceding numbers to check if the given number is divisible by a preceding number
+	if (givenNumber <= cache.table.limit())
 	{
-		if (givenNumber % i == 0) //If the number has a divisor other than 1 or itself, it's not a prime number
-		{
-			return 0;
-		}
+		return cache.table.sumUpTo(givenNumber);
 	}
-	return 1;
+	if (cache.sieve.extend(givenNumber, numThreads)) //no work if an earlier query sieved far enough
+	{
+		return cache.sieve.sumUpTo(givenNumber);
+	}
+	auto known = cache.lucySums.find(givenNumber);
+	if (known == cache.lucySums.end())
+	{
+		known = cache.lucySums.emplace(givenNumber, lucyPrimeSum(givenNumber, numThreads)).first;
+	}
+	return known->second;
 }
 
-int sumOfPrimes(int givenNumber) //This function computes the sum of all the preceding prime numbers to the given number -input is the given integer - the output is an integer that is the sum of all primes before the given number
+std::string toDecimal(unsigned __int128 value) //converts a 128-bit value to its decimal digits - iostream has no operator for unsigned __int128
 {
-	int sumOfPrimesValue = 0;
-	for (int i = 2; i <= givenNumber; i++)
+	std::string digits;
+	do
 	{
-		if (numberIsAPrime(i))
-		{
-			sumOfPrimesValue += i; //Loops through the preceding numbers and checks for prime numbers - if found, summed with the previous value of sumOfPrimesValue variable
-		}
-	}
-	return sumOfPrimesValue;
+		digits.insert(digits.begin(), static_cast<char>('0' + static_cast<int>(value % 10)));
+		value /= 10;
+	} while (value != 0);
+	return digits;
 }
 
 int inputValidityfn(const std::string& input) //to check if the given input is valid - input is the input string from the user - output is 0 if the input is invalid, 1 if it is valid
@@ -58,8 +97,105 @@ int inputValidityfn(const std::string& input) //to check if the given input is v
 	return 1;
 }
 
-int main(/* The code to execute the previous functions and outputs the sum of primes value to the user*/)
+int runBatch(const char* fileName, int numThreads) //batch mode - inputs are the file of numbers (- for stdin) and the number of threads - prints one sum per number in input order, the output is the exit code
+{
+	std::ifstream file;
+	if (strcmp(fileName, "-") != 0)
+	{
+		file.open(fileName);
+		if (!file)
+		{
+			std::cerr << "Error! Cannot read " << fileName << "\n";
+			return 1;
+		}
+	}
+	std::istream& input = (strcmp(fileName, "-") == 0) ? std::cin : file;
+	std::vector<std::uint64_t> queries;
+	std::string inputNumberString;
+	while (input >> inputNumberString)
+	{
+		if (!inputValidityfn(inputNumberString) || strtoull(inputNumberString.c_str(), nullptr, 10) > MAX_INPUT) //strtoull saturates, so too many digits fail the limit
+		{
+			std::cerr << "Error! Invalid input " << inputNumberString << " (number " << queries.size() + 1 << "), the largest accepted number is " << MAX_INPUT << "\n";
+			return 1;
+		}
+		queries.push_back(strtoull(inputNumberString.c_str(), nullptr, 10));
+	}
+
+	std::vector<unsigned __int128> sums = batchSumOfPrimes(queries, numThreads);
+	std::string output;
+	for (unsigned __int128 sum : sums)
+	{
+		output += toDecimal(sum);
+		output += '\n';
+	}
+	std::cout << output << std::flush;
+	return 0;
+}
+
+int main(int argc, char* argv[]) // The code to execute the previous functions and outputs the sum of primes value to the user - the optional argument -t <threads> sets the number of sieve threads, --build-table N writes a table file, --table <file> answers from one and --batch <file> answers a file of numbers
 {
+	int numThreads = 1;
+	const char* tableFile = nullptr;
+	const char* batchFile = nullptr;
+	bool buildTable = false;
+	std::uint64_t tableLimit = 0; //N of --build-table
+	QueryCache cache; //kept for every query of this run
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-t") == 0 && i + 1 < argc && inputValidityfn(argv[i + 1]))
+		{
+			numThreads = atoi(argv[++i]);
+			if (numThreads == 0) //0 threads: one per hardware thread
+			{
+				numThreads = std::max(1u, std::thread::hardware_concurrency());
+			}
+		}
+		else if (strcmp(argv[i], "--table") == 0 && i + 1 < argc)
+		{
+			tableFile = argv[++i];
+		}
+		else if (strcmp(argv[i], "--build-table") == 0 && i + 1 < argc && inputValidityfn(argv[i + 1])
+			&& strtoull(argv[i + 1], nullptr, 10) <= MAX_INPUT) //strtoull saturates, so too many digits fail the limit
+		{
+			tableLimit = strtoull(argv[++i], nullptr, 10);
+			buildTable = true;
+		}
+		else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc)
+		{
+			batchFile = argv[++i];
+		}
+		else
+		{
+			std::cout << "Usage: " << argv[0] << " [-t <threads>] [--table <file>] [--build-table <N>] [--batch <file or ->]\n";
+			return 1;
+		}
+	}
+
+	if (buildTable) //build mode: write the table and exit
+	{
+		if (tableFile == nullptr)
+		{
+			tableFile = DEFAULT_TABLE_FILE;
+		}
+		if (!buildPrimeTable(tableFile, tableLimit, numThreads))
+		{
+			std::cout << "Error! Cannot write the table " << tableFile << "\n";
+			return 1;
+		}
+		std::cout << "The prime sums up to " << tableLimit << " are written to " << tableFile << "\n";
+		return 0;
+	}
+	if (batchFile != nullptr)
+	{
+		return runBatch(batchFile, numThreads);
+	}
+	if (tableFile != nullptr && !cache.table.open(tableFile))
+	{
+		std::cout << "Error! " << tableFile << " is not a readable prime table\n";
+		return 1;
+	}
+
 	while (true)
 	{
 		std::string inputNumberString;
@@ -76,17 +212,18 @@ int main(/* The code to execute the previous functions and outputs the sum of pr
 		}
 		else
 		{
-			try // try block to handle the input<2^32 criteria
+			try // try block to handle inputs that do not fit 64 bits
 			{
-				int inputNumber = std::stoi(inputNumberString);
+				std::uint64_t inputNumber = std::stoull(inputNumberString);
 
-				if (inputNumber >= UINT32_MAX)
+				if (inputNumber > MAX_INPUT) //explicit upper limit of the accepted range
 				{
-					;
+					std::cout << "Error! Invalid input! The largest accepted number is " << MAX_INPUT << "\n";
+					continue;
 				}
-				int sumOfPrimesValue = 0;
-				sumOfPrimesValue = sumOfPrimes(inputNumber); //computes the sum of primes for the correct input
-				std::cout << "The sum of the primes is " << sumOfPrimesValue << "\n"; //outputs the sum of primes to the user
+				unsigned __int128 sumOfPrimesValue = 0;
+				sumOfPrimesValue = sumOfPrimes(cache, inputNumber, numThreads); //computes the sum of primes for the correct input
+				std::cout << "The sum of the primes is " << toDecimal(sumOfPrimesValue) << "\n"; //outputs the sum of primes to the user
 			}
 			catch (const std::out_of_range&) //outputs the invalid error statement
 			{
@@ -0,0 +1,188 @@
+/*
+Author: Kamya Hari
+Class: ECE 6122
+Last Date Modified: 10-18-2026
+
+Description:
+Sum of the primes up to n in O(n^(3/4)) time and O(sqrt(n)) memory with Lucy_Hedgehog's method. S(v), the sum of the
+integers in [2, v] that survive sieving by the primes below p, is only ever needed for the values v = n / k. Those are
+v = 1, ..., r (r = isqrt(n)) and v = n / i for i = 1, ..., r. S(v) starts as 2 + 3 + ... + v, and every prime p <= r
+removes its multiples from every v >= p * p:
+    S(v) -= p * (S(v / p) - S(p - 1))
+where S(p - 1) is the sum of the primes below p. Values are updated from the largest v down, so S(v / p) still holds
+the value from before p. At the end S(n) is the answer. The sum of the primes up to n passes 2^64 near n = 3e10, so
+S(n / i) is kept as unsigned __int128 while n / i >= 2^32. Every other S(v) is below 2^63 and is kept in 64 bits; this
+halves the memory traffic of the loop over the large values, which is what limits the speed.
+That loop (large values whose n / (i * p) is a small value) only reads small[], so its iterations are independent. With
+several threads, it is split between persistent worker threads for every prime whose range is big enough. The other two
+loops are short and stay on the calling thread.
+*/
+
+#ifndef LUCY_PRIME_SUM_H
+#define LUCY_PRIME_SUM_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "primeSieve.h"
+
+const std::uint64_t LUCY_PARALLEL_MIN = std::uint64_t(1) << 16; // large values a prime must update before it is split between threads
+
+inline unsigned __int128 lucyPrimeSum(std::uint64_t n, int numThreads = 1) // sum of the primes <= n
+{
+	if (n < 2)
+	{
+		return 0;
+	}
+	const std::uint64_t r = integerSquareRoot(n);
+	const std::uint64_t wideCount = std::min(r, n >> 32); // S(n / i) needs 128 bits only while n / i >= 2^32
+	std::vector<std::uint64_t> small(r + 1); // small[v] = S(v)
+	std::vector<unsigned __int128> wide(wideCount + 1); // wide[i] = S(n / i) for i <= wideCount
+	std::vector<std::uint64_t> narrow(r + 1); // narrow[i] = S(n / i) for wideCount < i <= r
+	for (std::uint64_t v = 1; v <= r; v++)
+	{
+		small[v] = v * (v + 1) / 2 - 1;
+	}
+	for (std::uint64_t i = 1; i <= r; i++)
+	{
+		unsigned __int128 v = n / i;
+		if (i <= wideCount)
+		{
+			wide[i] = v * (v + 1) / 2 - 1;
+		}
+		else
+		{
+			narrow[i] = static_cast<std::uint64_t>(v * (v + 1) / 2 - 1);
+		}
+	}
+
+	// narrow[i] or wide[i] -= p * (S(n / (i * p)) - S(p - 1)) for first <= i <= last, where n / (i * p) <= r
+	auto updateFromSmall = [&](std::uint64_t p, std::uint64_t primesBelow, std::uint64_t first, std::uint64_t last)
+	{
+		// n / (i * p) = np / i, by a floating-point division that is off by at most one, then corrected
+		const std::uint64_t np = n / p;
+		const double npDouble = static_cast<double>(np);
+		auto quotient = [&](std::uint64_t i)
+		{
+			std::uint64_t q = static_cast<std::uint64_t>(npDouble / static_cast<double>(i));
+			return q - ((q * i > np) ? 1 : 0);
+		};
+		for (std::uint64_t i = first; i <= std::min(last, wideCount); i++)
+		{
+			wide[i] -= static_cast<unsigned __int128>(p) * (small[quotient(i)] - primesBelow);
+		}
+		for (std::uint64_t i = std::max(first, wideCount + 1); i <= last; i++)
+		{
+			narrow[i] -= p * (small[quotient(i)] - primesBelow);
+		}
+	};
+
+	// Worker t of numThreads takes the t-th slice of [jobFirst, jobLast] every time the generation changes
+	std::mutex mutex;
+	std::condition_variable wake, finished;
+	std::uint64_t generation = 0, jobPrime = 0, jobBelow = 0, jobFirst = 0, jobLast = 0;
+	int busy = 0;
+	bool stopping = false;
+	auto slice = [&](int t, std::uint64_t p, std::uint64_t primesBelow, std::uint64_t first, std::uint64_t last)
+	{
+		std::uint64_t count = last - first + 1;
+		updateFromSmall(p, primesBelow, first + count * t / numThreads, first + count * (t + 1) / numThreads - 1);
+	};
+	std::vector<std::thread> workers;
+	for (int t = 1; t < numThreads; t++)
+	{
+		workers.emplace_back([&, t]
+		{
+			std::uint64_t seen = 0;
+			std::unique_lock<std::mutex> lock(mutex);
+			while (true)
+			{
+				wake.wait(lock, [&] { return generation != seen || stopping; });
+				if (stopping)
+				{
+					return;
+				}
+				seen = generation;
+				std::uint64_t p = jobPrime, primesBelow = jobBelow, first = jobFirst, last = jobLast;
+				lock.unlock();
+				slice(t, p, primesBelow, first, last);
+				lock.lock();
+				if (--busy == 0)
+				{
+					finished.notify_one();
+				}
+			}
+		});
+	}
+
+	for (std::uint64_t p = 2; p <= r; p++)
+	{
+		if (small[p] == small[p - 1])
+		{
+			continue; // p is composite
+		}
+		const std::uint64_t primesBelow = small[p - 1];
+		const std::uint64_t square = p * p;
+		// Large values n / i >= p^2; n / (i * p) is a large value while i * p <= r, a small one after that
+		const std::uint64_t lastLarge = std::min(r, n / square);
+		const std::uint64_t sharedLarge = std::min(lastLarge, r / p);
+		for (std::uint64_t i = 1; i <= sharedLarge; i++)
+		{
+			std::uint64_t j = i * p;
+			unsigned __int128 update = static_cast<unsigned __int128>(p) * ((j <= wideCount ? wide[j] : narrow[j]) - primesBelow);
+			if (i <= wideCount)
+			{
+				wide[i] -= update;
+			}
+			else
+			{
+				narrow[i] -= static_cast<std::uint64_t>(update);
+			}
+		}
+		if (numThreads > 1 && lastLarge - sharedLarge >= LUCY_PARALLEL_MIN)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				jobPrime = p;
+				jobBelow = primesBelow;
+				jobFirst = sharedLarge + 1;
+				jobLast = lastLarge;
+				busy = numThreads - 1;
+				generation++;
+			}
+			wake.notify_all();
+			slice(0, p, primesBelow, sharedLarge + 1, lastLarge);
+			std::unique_lock<std::mutex> lock(mutex);
+			finished.wait(lock, [&] { return busy == 0; });
+		}
+		else if (lastLarge > sharedLarge)
+		{
+			updateFromSmall(p, primesBelow, sharedLarge + 1, lastLarge);
+		}
+		// Small values from r down to p^2, in runs of p values that share the quotient q = v / p
+		for (std::uint64_t q = r / p; q >= p; q--)
+		{
+			const std::uint64_t update = p * (small[q] - primesBelow);
+			const std::uint64_t runEnd = std::min(r, q * p + p - 1);
+			for (std::uint64_t v = runEnd; v >= q * p; v--)
+			{
+				small[v] -= update;
+			}
+		}
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+	return wideCount >= 1 ? wide[1] : narrow[1];
+}
+
+#endif // LUCY_PRIME_SUM_H
@@ -0,0 +1,124 @@
+/*
+Author: Kamya Hari
+Class: ECE 6122
+Last Date Modified: 10-18-2026
+
+Description:
+Answers many prime-sum queries at once (--batch). The queries are sorted and a single sieve sweep runs up to the
+largest one it answers, instead of one sieve or Lucy call per query. A sieved segment answers every query that ends in
+it: one walk over its words in query order gives the sum of the primes up to each of those queries within the segment,
+and the walk ends with the segment total. Once the sweep is over, each answer is 2 plus the totals of the segments
+before it plus its partial sum. The segments can therefore be sieved on the -t threads in any order.
+Sweeping up to n costs about n sieved integers, a Lucy call about n^(3/4) of them (BATCH_LUCY_COST). A few queries far
+above the rest would make the sweep much longer than answering them on their own, so the sweep stops at the query that
+makes the total of the two costs smallest, and every distinct query above it gets one Lucy call.
+*/
+
+#ifndef PRIME_BATCH_H
+#define PRIME_BATCH_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+#include "primeSieve.h"
+#include "lucyPrimeSum.h"
+
+const double BATCH_LUCY_COST = 1.0; // sieved integers per n^(3/4) that one Lucy call takes as long as (1 s for 10^9 sieved, 0.6 s for Lucy at 10^12)
+
+inline std::vector<unsigned __int128> batchSumOfPrimes(const std::vector<std::uint64_t>& queries, int numThreads = 1) // sum of the primes <= queries[i] for every i, in the order of the queries
+{
+	std::vector<std::size_t> order(queries.size()); // positions of the queries, smallest query first
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return queries[a] < queries[b]; });
+	std::vector<std::uint64_t> values; // the distinct queries >= 3, ascending
+	for (std::size_t i : order)
+	{
+		if (queries[i] >= 3 && (values.empty() || values.back() != queries[i]))
+		{
+			values.push_back(queries[i]);
+		}
+	}
+
+	// Sieve the smallest 'sieved' values with one sweep up to the largest of them, give the others to the Lucy method
+	std::vector<double> lucyCost(values.size() + 1, 0.0); // lucyCost[k] = cost of Lucy calls for values[k] and above
+	for (std::size_t k = values.size(); k-- > 0;)
+	{
+		lucyCost[k] = lucyCost[k + 1] + BATCH_LUCY_COST * std::pow(static_cast<double>(values[k]), 0.75);
+	}
+	std::size_t sieved = 0;
+	for (std::size_t k = 1; k <= values.size(); k++)
+	{
+		if (static_cast<double>(values[k - 1]) + lucyCost[k] < (sieved == 0 ? 0.0 : static_cast<double>(values[sieved - 1])) + lucyCost[sieved])
+		{
+			sieved = k;
+		}
+	}
+
+	std::vector<unsigned __int128> valueSums(values.size(), 0);
+	if (sieved > 0)
+	{
+		const std::uint64_t sweepLimit = values[sieved - 1];
+		const std::vector<std::uint32_t> primes = basePrimes(static_cast<std::uint32_t>(integerSquareRoot(sweepLimit)));
+		std::vector<unsigned __int128> segmentSums((sweepLimit / 2) / SIEVE_SEGMENT_BITS + 1, 0);
+		sieveRange(primes, 3, sweepLimit, numThreads, [&](int, const SegmentedSieve& sieve)
+		{
+			// Segments start at multiples of SIEVE_SEGMENT_BITS odd indices, so each one only writes its own entries
+			const std::uint64_t first = sieve.firstIndex();
+			const std::vector<std::uint64_t>& bits = sieve.segment();
+			std::size_t k = std::lower_bound(values.begin(), values.begin() + sieved, 2 * first + 1) - values.begin();
+			unsigned __int128 sum = 0; // primes in the words before w
+			std::uint64_t w = 0;
+			for (; k < sieved && (values[k] - 1) / 2 < first + SIEVE_SEGMENT_BITS; k++)
+			{
+				const std::uint64_t bit = (values[k] - 1) / 2 - first; // of the largest odd number <= values[k]
+				for (; w < bit / 64; w++)
+				{
+					sum += wordPrimeSum(first + 64 * w, bits[w]);
+				}
+				const std::uint64_t mask = (bit % 64 == 63) ? ~std::uint64_t(0) : (std::uint64_t(2) << (bit % 64)) - 1;
+				valueSums[k] = sum + wordPrimeSum(first + 64 * w, bits[w] & mask);
+			}
+			for (; w < bits.size(); w++)
+			{
+				sum += wordPrimeSum(first + 64 * w, bits[w]);
+			}
+			segmentSums[first / SIEVE_SEGMENT_BITS] = sum;
+		});
+
+		unsigned __int128 before = 2; // 2, then the primes of every segment before values[k]'s
+		std::uint64_t segment = 0;
+		for (std::size_t k = 0; k < sieved; k++)
+		{
+			for (; segment < ((values[k] - 1) / 2) / SIEVE_SEGMENT_BITS; segment++)
+			{
+				before += segmentSums[segment];
+			}
+			valueSums[k] += before;
+		}
+	}
+	for (std::size_t k = sieved; k < values.size(); k++)
+	{
+		valueSums[k] = lucyPrimeSum(values[k], numThreads);
+	}
+
+	std::vector<unsigned __int128> answers(queries.size(), 0);
+	std::size_t k = 0;
+	for (std::size_t i : order)
+	{
+		if (queries[i] < 3)
+		{
+			answers[i] = queries[i] == 2 ? 2 : 0;
+			continue;
+		}
+		while (values[k] != queries[i])
+		{
+			k++;
+		}
+		answers[i] = valueSums[k];
+	}
+	return answers;
+}
+
+#endif // PRIME_BATCH_H
@@ -0,0 +1,323 @@
+/*
+Author: Kamya Hari
+Class: ECE 6122
+Last Date Modified: 10-18-2026
+
+Description:
+Segmented Sieve of Eratosthenes over odd numbers only. Bit i of a segment stands for the odd number 2 * (first + i) + 1,
+where first is the segment's first odd index; a set bit means prime. A segment is SIEVE_SEGMENT_WORDS 64-bit words
+(32 KiB, the size of a typical L1 data cache), i.e. 524288 consecutive integers. Segments always start at a multiple
+of SIEVE_SEGMENT_BITS odd indices, whatever the range, so the segments of different ranges never overlap in part.
+The 2 * 3 * 5 * 7 wheel is used twice. Each segment starts as a copy of a precomputed pattern with the odd multiples of
+3, 5 and 7 already cleared. Every larger base prime p then only crosses off p * m for multipliers m coprime to 210,
+which are 48 of every 105 odd multipliers.
+With several threads, the range is cut into blocks of SIEVE_BLOCK_SEGMENTS segments. Each thread repeatedly claims
+the next unclaimed block and sieves it with its own SegmentedSieve. The blocks start on segment boundaries, so every
+segment, and every word of the bitmap, belongs to exactly one block.
+Only the base-prime list is shared, read-only, and every thread keeps its own partial sum until the threads are joined.
+*/
+
+#ifndef PRIME_SIEVE_H
+#define PRIME_SIEVE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+const std::uint64_t SIEVE_SEGMENT_WORDS = 4096; // 32 KiB of bits per segment
+const std::uint64_t SIEVE_SEGMENT_BITS = SIEVE_SEGMENT_WORDS * 64;
+const int WHEEL_MODULUS = 210; // 2 * 3 * 5 * 7
+const int WHEEL_SPOKES = 48; // residues modulo 210 that are coprime to 210
+const int PATTERN_WORDS = 105; // the 3 * 5 * 7 pre-sieve pattern repeats every 105 odd numbers, so every 105 words
+const std::uint64_t SIEVE_BLOCK_SEGMENTS = 64; // segments a thread claims at a time (about 3.4e7 integers)
+
+inline std::uint64_t integerSquareRoot(std::uint64_t n) // largest r with r * r <= n
+{
+	std::uint64_t r = 0;
+	for (std::uint64_t bit = std::uint64_t(1) << 31; bit != 0; bit >>= 1)
+	{
+		std::uint64_t candidate = r | bit;
+		if (candidate * candidate <= n)
+		{
+			r = candidate;
+		}
+	}
+	return r;
+}
+
+inline std::vector<std::uint32_t> basePrimes(std::uint32_t limit) // the odd primes up to limit, from a plain sieve - they cross off the segments
+{
+	std::vector<char> composite(limit + 1, 0);
+	std::vector<std::uint32_t> primes;
+	for (std::uint64_t i = 3; i <= limit; i += 2)
+	{
+		if (!composite[i])
+		{
+			primes.push_back(static_cast<std::uint32_t>(i));
+			for (std::uint64_t j = i * i; j <= limit; j += 2 * i)
+			{
+				composite[j] = 1;
+			}
+		}
+	}
+	return primes;
+}
+
+struct SieveWheel // tables of the 210 wheel, built once
+{
+	int spoke[WHEEL_MODULUS]; // position of a residue among the 48 coprime ones, -1 if it shares a factor with 210
+	std::uint32_t halfGap[WHEEL_SPOKES]; // (next coprime residue - this one) / 2: the step in odd indices for a multiplier of 1
+	std::uint64_t pattern[PATTERN_WORDS]; // bit j set unless the odd number 2j + 1 is a multiple of 3, 5 or 7
+
+	SieveWheel()
+	{
+		int residues[WHEEL_SPOKES];
+		int count = 0;
+		for (int r = 0; r < WHEEL_MODULUS; r++)
+		{
+			bool coprime = r % 2 != 0 && r % 3 != 0 && r % 5 != 0 && r % 7 != 0;
+			spoke[r] = coprime ? count : -1;
+			if (coprime)
+			{
+				residues[count++] = r;
+			}
+		}
+		for (int s = 0; s < WHEEL_SPOKES; s++)
+		{
+			int next = (s + 1 < WHEEL_SPOKES) ? residues[s + 1] : residues[0] + WHEEL_MODULUS;
+			halfGap[s] = static_cast<std::uint32_t>((next - residues[s]) / 2);
+		}
+		for (int w = 0; w < PATTERN_WORDS; w++)
+		{
+			pattern[w] = 0;
+			for (int b = 0; b < 64; b++)
+			{
+				std::uint64_t value = 2 * (64 * static_cast<std::uint64_t>(w) + b) + 1;
+				if (value % 3 != 0 && value % 5 != 0 && value % 7 != 0)
+				{
+					pattern[w] |= std::uint64_t(1) << b;
+				}
+			}
+		}
+	}
+};
+
+inline const SieveWheel& sieveWheel()
+{
+	static const SieveWheel wheel;
+	return wheel;
+}
+
+class SegmentedSieve // the primes in [low, high], one segment at a time
+{
+public:
+	SegmentedSieve(const std::vector<std::uint32_t>& primes, std::uint64_t low, std::uint64_t high) // primes must hold the odd primes up to sqrt(high)
+		: primes(primes), low(low), high(high), bits(SIEVE_SEGMENT_WORDS)
+	{
+		first = (low / 2) / SIEVE_SEGMENT_BITS * SIEVE_SEGMENT_BITS; // on the segment grid, even if low is not
+		nextFirst = first;
+		const SieveWheel& wheel = sieveWheel();
+		for (std::uint32_t p : primes)
+		{
+			if (p < 11)
+			{
+				continue; // 3, 5 and 7 are in the pattern
+			}
+			if (static_cast<std::uint64_t>(p) * p > high)
+			{
+				break;
+			}
+			// First multiplier m >= p on the wheel whose multiple p * m is not below this range
+			std::uint64_t m = 2 * first + 1 > p ? (2 * first + 1 + p - 1) / p : 1;
+			if (m < p)
+			{
+				m = p;
+			}
+			while (wheel.spoke[m % WHEEL_MODULUS] < 0)
+			{
+				m++;
+			}
+			crossings.push_back({ (p * m - 1) / 2, p, static_cast<std::uint32_t>(wheel.spoke[m % WHEEL_MODULUS]) });
+		}
+	}
+
+	bool next() // sieves the next segment; false once the range is exhausted
+	{
+		if (2 * nextFirst + 1 > high || (low > high))
+		{
+			return false;
+		}
+		first = nextFirst;
+		nextFirst += SIEVE_SEGMENT_BITS;
+		const std::uint64_t end = nextFirst;
+		const SieveWheel& wheel = sieveWheel();
+
+		std::uint64_t patternWord = (first / 64) % PATTERN_WORDS;
+		for (std::uint64_t w = 0; w < SIEVE_SEGMENT_WORDS; w++)
+		{
+			bits[w] = wheel.pattern[patternWord];
+			if (++patternWord == PATTERN_WORDS)
+			{
+				patternWord = 0;
+			}
+		}
+		if (first == 0)
+		{
+			bits[0] = (bits[0] & ~std::uint64_t(1)) | 0xE; // 1 is not prime, 3, 5 and 7 are
+		}
+
+		for (Crossing& c : crossings)
+		{
+			std::uint64_t index = c.index;
+			std::uint32_t spoke = c.spoke;
+			while (index < end)
+			{
+				std::uint64_t bit = index - first;
+				bits[bit / 64] &= ~(std::uint64_t(1) << (bit % 64));
+				index += static_cast<std::uint64_t>(c.prime) * wheel.halfGap[spoke];
+				if (++spoke == WHEEL_SPOKES)
+				{
+					spoke = 0;
+				}
+			}
+			c.index = index;
+			c.spoke = spoke;
+		}
+
+		// Numbers outside [low, high] at the two ends of the range
+		if (low / 2 > first) // the odd indices below low / 2 are the odd numbers below low
+		{
+			std::uint64_t below = std::min(low / 2, end) - first;
+			for (std::uint64_t w = 0; w < below / 64; w++)
+			{
+				bits[w] = 0;
+			}
+			if (below % 64 != 0)
+			{
+				bits[below / 64] &= ~((std::uint64_t(1) << (below % 64)) - 1);
+			}
+		}
+		if (2 * (end - 1) + 1 > high)
+		{
+			std::uint64_t last = (high - 1) / 2 - first; // bit of the largest odd number <= high
+			std::uint64_t word = last / 64;
+			bits[word] &= (last % 64 == 63) ? ~std::uint64_t(0) : (std::uint64_t(2) << (last % 64)) - 1;
+			for (std::uint64_t w = word + 1; w < SIEVE_SEGMENT_WORDS; w++)
+			{
+				bits[w] = 0;
+			}
+		}
+		return true;
+	}
+
+	std::uint64_t firstIndex() const { return first; } // odd index of bit 0 of the current segment
+	const std::vector<std::uint64_t>& segment() const { return bits; } // set bit i: 2 * (firstIndex() + i) + 1 is prime
+
+private:
+	struct Crossing // next odd index to cross off for one base prime, and where its multiplier is on the wheel
+	{
+		std::uint64_t index;
+		std::uint32_t prime;
+		std::uint32_t spoke;
+	};
+
+	const std::vector<std::uint32_t>& primes;
+	std::uint64_t low, high;
+	std::uint64_t first, nextFirst;
+	std::vector<std::uint64_t> bits;
+	std::vector<Crossing> crossings;
+};
+
+inline std::uint64_t bitPositionSum(std::uint64_t word) // sum of the positions of the set bits: bit k of a position is set in the positions selected by mask k
+{
+	return static_cast<std::uint64_t>(__builtin_popcountll(word & 0xAAAAAAAAAAAAAAAAULL))
+		+ 2 * static_cast<std::uint64_t>(__builtin_popcountll(word & 0xCCCCCCCCCCCCCCCCULL))
+		+ 4 * static_cast<std::uint64_t>(__builtin_popcountll(word & 0xF0F0F0F0F0F0F0F0ULL))
+		+ 8 * static_cast<std::uint64_t>(__builtin_popcountll(word & 0xFF00FF00FF00FF00ULL))
+		+ 16 * static_cast<std::uint64_t>(__builtin_popcountll(word & 0xFFFF0000FFFF0000ULL))
+		+ 32 * static_cast<std::uint64_t>(__builtin_popcountll(word & 0xFFFFFFFF00000000ULL));
+}
+
+inline std::uint64_t wordPrimeSum(std::uint64_t index, std::uint64_t word) // sum of the primes marked in a word whose bit 0 is the odd index 'index'
+{
+	// at most 64 primes below 2^64 / 128 each: fits 64 bits
+	return (2 * index + 1) * static_cast<std::uint64_t>(__builtin_popcountll(word)) + 2 * bitPositionSum(word);
+}
+
+inline unsigned __int128 segmentPrimeSum(std::uint64_t first, const std::vector<std::uint64_t>& bits) // sum of the primes marked in one segment
+{
+	unsigned __int128 sum = 0;
+	for (std::uint64_t w = 0; w < bits.size(); w++)
+	{
+		sum += wordPrimeSum(first + 64 * w, bits[w]);
+	}
+	return sum;
+}
+
+// Sieves the odd numbers in [low, high] (low >= 3) on numThreads threads and calls visit(t, sieve) on thread t for every
+// segment; every segment is visited exactly once. primes must hold the odd primes up to sqrt(high).
+template <typename SegmentVisitor>
+void sieveRange(const std::vector<std::uint32_t>& primes, std::uint64_t low, std::uint64_t high, int numThreads, SegmentVisitor visit)
+{
+	if (low > high)
+	{
+		return;
+	}
+	const std::uint64_t blockValues = 2 * SIEVE_BLOCK_SEGMENTS * SIEVE_SEGMENT_BITS; // integers per block
+	const std::uint64_t firstBlock = low / blockValues;
+	const std::uint64_t numBlocks = high / blockValues - firstBlock + 1;
+	if (static_cast<std::uint64_t>(numThreads) > numBlocks)
+	{
+		numThreads = static_cast<int>(numBlocks);
+	}
+
+	std::atomic<std::uint64_t> nextBlock(0);
+	auto worker = [&](int t)
+	{
+		for (std::uint64_t block = nextBlock++; block < numBlocks; block = nextBlock++)
+		{
+			std::uint64_t blockLow = block == 0 ? low : (firstBlock + block) * blockValues;
+			std::uint64_t blockHigh = (block + 1 == numBlocks) ? high : (firstBlock + block + 1) * blockValues - 1;
+			SegmentedSieve sieve(primes, blockLow, blockHigh);
+			while (sieve.next())
+			{
+				visit(t, sieve);
+			}
+		}
+	};
+	std::vector<std::thread> threads;
+	for (int t = 1; t < numThreads; t++)
+	{
+		threads.emplace_back(worker, t);
+	}
+	worker(0);
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+inline unsigned __int128 sieveSumOfPrimes(std::uint64_t n, int numThreads = 1) // sum of the primes <= n, sieved by numThreads threads
+{
+	if (n < 2)
+	{
+		return 0;
+	}
+	const std::vector<std::uint32_t> primes = basePrimes(static_cast<std::uint32_t>(integerSquareRoot(n)));
+	std::vector<unsigned __int128> partialSums(std::max(numThreads, 1), 0);
+	sieveRange(primes, 3, n, numThreads, [&](int t, const SegmentedSieve& sieve)
+	{
+		partialSums[t] += segmentPrimeSum(sieve.firstIndex(), sieve.segment());
+	});
+
+	unsigned __int128 sum = 2;
+	for (unsigned __int128 partial : partialSums)
+	{
+		sum += partial;
+	}
+	return sum;
+}
+
+#endif // PRIME_SIEVE_H
@@ -0,0 +1,93 @@
+/*
+Author: Kamya Hari
+Class: ECE 6122
+Last Date Modified: 10-18-2026
+
+Description:
+Sieve that persists across the queries of one run of Problem 2. It keeps the odd-prime bitmap of the sieve (bit i of
+word w: the odd number 2 * (64 * w + i) + 1 is prime) and, for every word, the sum of all primes below that word.
+A query n <= limit() is then the prefix of its word plus the primes of one masked word, which bitPositionSum() adds
+with six popcounts: O(1) however large n is. A larger n extends the bitmap by sieving only the numbers that are new,
+on the -t threads, and grows it at least twice each time, so a series of growing queries costs about one sieve up to
+the largest of them. A word and its prefix take 16 bytes for 128 integers, e.g. 32 MiB up to 2^28.
+*/
+
+#ifndef PRIME_SUM_CACHE_H
+#define PRIME_SUM_CACHE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "primeSieve.h"
+
+const std::uint64_t PRIME_CACHE_MIN = std::uint64_t(1) << 20; // smallest extension: sieving less is not worth a call
+
+class PrimeSumCache // the primes up to limit() and the sums of all primes below every bitmap word
+{
+public:
+	explicit PrimeSumCache(std::uint64_t maxLimit) : maxLimit(maxLimit) {} // the bitmap never grows past maxLimit (below 2^32, so every prefix fits 64 bits)
+
+	std::uint64_t limit() const { return covered; } // every n <= limit() is answered from the bitmap
+
+	bool extend(std::uint64_t n, int numThreads = 1) // sieves (limit(), max(n, 2 * limit(), PRIME_CACHE_MIN)], at most up to maxLimit - false if n > maxLimit
+	{
+		if (n <= covered)
+		{
+			return true;
+		}
+		if (n > maxLimit)
+		{
+			return false;
+		}
+		n = std::min(maxLimit, std::max(n, std::max(2 * covered, PRIME_CACHE_MIN)));
+		const std::uint64_t oldWords = bits.size();
+		const std::uint64_t words = (n / 2) / 64 + 1;
+		bits.resize(words, 0);
+		prefix.resize(words, 0);
+
+		// The segments start on the segment grid, so every segment word is a bitmap word and belongs to one block: the
+		// threads never write the same word. The sieve clears the numbers outside the new range, so the word shared with
+		// the old range is combined with an or.
+		const std::vector<std::uint32_t> primes = basePrimes(static_cast<std::uint32_t>(integerSquareRoot(n)));
+		sieveRange(primes, std::max<std::uint64_t>(covered + 1, 3), n, numThreads, [&](int, const SegmentedSieve& sieve)
+		{
+			const std::vector<std::uint64_t>& segment = sieve.segment();
+			const std::uint64_t firstWord = sieve.firstIndex() / 64;
+			for (std::uint64_t w = 0; w < segment.size() && firstWord + w < words; w++)
+			{
+				bits[firstWord + w] |= segment[w];
+			}
+		});
+
+		const std::uint64_t firstNew = oldWords == 0 ? 0 : oldWords - 1; // the last old word gained primes
+		std::uint64_t sum = firstNew == 0 ? 2 : prefix[firstNew]; // 2 is not in the bitmap
+		for (std::uint64_t w = firstNew; w < words; w++)
+		{
+			prefix[w] = sum;
+			sum += wordPrimeSum(64 * w, bits[w]);
+		}
+		covered = n;
+		return true;
+	}
+
+	unsigned __int128 sumUpTo(std::uint64_t n) const // sum of the primes <= n, for n <= limit()
+	{
+		if (n < 2)
+		{
+			return 0;
+		}
+		const std::uint64_t index = (n - 1) / 2; // odd index of the largest odd number <= n
+		const std::uint64_t w = index / 64;
+		const std::uint64_t bit = index % 64;
+		const std::uint64_t word = bits[w] & ((bit == 63) ? ~std::uint64_t(0) : (std::uint64_t(2) << bit) - 1);
+		return static_cast<unsigned __int128>(prefix[w]) + wordPrimeSum(64 * w, word);
+	}
+
+private:
+	std::uint64_t maxLimit;
+	std::uint64_t covered = 0;
+	std::vector<std::uint64_t> bits; // odd-prime bitmap, one bit per odd number up to covered
+	std::vector<std::uint64_t> prefix; // prefix[w] = sum of the primes below 2 * 64 * w + 1, including 2
+};
+
+#endif // PRIME_SUM_CACHE_H
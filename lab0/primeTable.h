@@ -0,0 +1,201 @@
+/*
+Author: Kamya Hari
+Class: ECE 6122
+Last Date Modified: 10-18-2026
+
+Description:
+Precomputed table of prime sums on disk (--build-table N, --table <file>). The file is a PrimeTableHeader, then the sum
+of the primes below every multiple of PRIME_TABLE_STRIDE integers, 2 included (128 bits each, stored as low and high
+64-bit halves), then the odd-prime bitmap of the sieve (bit i of word w: the odd number 2 * (64 * w + i) + 1 is prime).
+The bitmap takes N / 16 bytes, the samples N / 256, so 10^9 needs about 66 MB.
+A query maps the file read-only and answers n <= N from the sample below n plus the primes in at most
+PRIME_TABLE_STRIDE / 128 bitmap words, so it touches one or two pages. Opening the table reads only its header, and
+every process that maps the file shares the same pages of the OS page cache, so starting up takes milliseconds.
+The builder maps the new file writable and lets the sieve threads write the bitmap in place: the sieve blocks start at
+multiples of 64 odd numbers, so every bitmap word belongs to exactly one segment. The file is written under a temporary
+name and renamed once it is complete, so a reader never maps a half-written table.
+*/
+
+#ifndef PRIME_TABLE_H
+#define PRIME_TABLE_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "primeSieve.h"
+
+const std::uint64_t PRIME_TABLE_MAGIC = 0x3142415453455250ULL; // "PRESTAB1" in little-endian byte order
+const std::uint64_t PRIME_TABLE_STRIDE = 4096; // integers between two samples, a multiple of the 128 of a bitmap word
+
+struct PrimeTableHeader // start of the table file
+{
+	std::uint64_t magic;
+	std::uint64_t limit; // N: the table answers every n <= N
+	std::uint64_t stride; // integers between two samples
+	std::uint64_t samples; // sample s = 2 + the sum of the odd primes below s * stride
+	std::uint64_t words; // 64-bit words of the bitmap
+	std::uint64_t reserved[3];
+};
+static_assert(sizeof(PrimeTableHeader) == 64, "PrimeTableHeader must have no padding");
+
+inline PrimeTableHeader primeTableHeader(std::uint64_t n) // header of the table up to n
+{
+	PrimeTableHeader header;
+	std::memset(&header, 0, sizeof(header));
+	header.magic = PRIME_TABLE_MAGIC;
+	header.limit = n;
+	header.stride = PRIME_TABLE_STRIDE;
+	header.samples = n / PRIME_TABLE_STRIDE + 1;
+	header.words = (n / 2) / 64 + 1;
+	return header;
+}
+
+inline std::uint64_t primeTableBytes(const PrimeTableHeader& header) // size of the whole file
+{
+	return sizeof(PrimeTableHeader) + 16 * header.samples + 8 * header.words;
+}
+
+inline bool buildPrimeTable(const std::string& path, std::uint64_t n, int numThreads = 1) // writes the table up to n to path - false if the file cannot be written
+{
+	const PrimeTableHeader header = primeTableHeader(n);
+	const std::uint64_t bytes = primeTableBytes(header);
+	const std::string temporary = path + ".tmp";
+	int fd = ::open(temporary.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+	{
+		return false;
+	}
+	void* mapping = MAP_FAILED;
+	if (ftruncate(fd, static_cast<off_t>(bytes)) == 0)
+	{
+		mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	}
+	if (mapping == MAP_FAILED)
+	{
+		::close(fd);
+		unlink(temporary.c_str());
+		return false;
+	}
+	unsigned char* base = static_cast<unsigned char*>(mapping);
+	std::uint64_t* samples = reinterpret_cast<std::uint64_t*>(base + sizeof(PrimeTableHeader));
+	std::uint64_t* bits = samples + 2 * header.samples; // the file starts zeroed, so words the sieve skips stay empty
+
+	if (n >= 3)
+	{
+		const std::vector<std::uint32_t> primes = basePrimes(static_cast<std::uint32_t>(integerSquareRoot(n)));
+		sieveRange(primes, 3, n, numThreads, [&](int, const SegmentedSieve& sieve)
+		{
+			const std::vector<std::uint64_t>& segment = sieve.segment();
+			const std::uint64_t firstWord = sieve.firstIndex() / 64;
+			for (std::uint64_t w = 0; w < segment.size() && firstWord + w < header.words; w++)
+			{
+				bits[firstWord + w] = segment[w];
+			}
+		});
+	}
+
+	const std::uint64_t wordsPerSample = PRIME_TABLE_STRIDE / 128;
+	unsigned __int128 sum = n >= 2 ? 2 : 0; // 2 is not in the bitmap
+	for (std::uint64_t s = 0; s < header.samples; s++)
+	{
+		samples[2 * s] = static_cast<std::uint64_t>(sum);
+		samples[2 * s + 1] = static_cast<std::uint64_t>(sum >> 64);
+		for (std::uint64_t w = s * wordsPerSample; w < (s + 1) * wordsPerSample && w < header.words; w++)
+		{
+			sum += wordPrimeSum(64 * w, bits[w]);
+		}
+	}
+	std::memcpy(base, &header, sizeof(header));
+
+	bool written = msync(mapping, bytes, MS_SYNC) == 0;
+	munmap(mapping, bytes);
+	written = ::close(fd) == 0 && written;
+	if (!written || rename(temporary.c_str(), path.c_str()) != 0)
+	{
+		unlink(temporary.c_str());
+		return false;
+	}
+	return true;
+}
+
+class PrimeTable // a table file mapped read-only
+{
+public:
+	PrimeTable() = default;
+	PrimeTable(const PrimeTable&) = delete;
+	PrimeTable& operator=(const PrimeTable&) = delete;
+
+	~PrimeTable()
+	{
+		if (mapping != nullptr)
+		{
+			munmap(mapping, mappedBytes);
+		}
+	}
+
+	bool open(const std::string& path) // maps the table at path - false if it is missing, not a table or truncated
+	{
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			return false;
+		}
+		struct stat status;
+		PrimeTableHeader header;
+		bool valid = fstat(fd, &status) == 0 && pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header))
+			&& header.magic == PRIME_TABLE_MAGIC && header.stride == PRIME_TABLE_STRIDE
+			&& header.samples == header.limit / header.stride + 1 && header.words == (header.limit / 2) / 64 + 1
+			&& static_cast<std::uint64_t>(status.st_size) == primeTableBytes(header);
+		void* map = valid ? mmap(nullptr, primeTableBytes(header), PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+		::close(fd); // the mapping stays valid without the descriptor
+		if (map == MAP_FAILED)
+		{
+			return false;
+		}
+		madvise(map, primeTableBytes(header), MADV_RANDOM); // a query reads one or two pages: no read-ahead
+		if (mapping != nullptr)
+		{
+			munmap(mapping, mappedBytes);
+		}
+		mapping = map;
+		mappedBytes = primeTableBytes(header);
+		covered = header.limit;
+		samples = reinterpret_cast<const std::uint64_t*>(static_cast<const unsigned char*>(map) + sizeof(PrimeTableHeader));
+		bits = samples + 2 * header.samples;
+		return true;
+	}
+
+	std::uint64_t limit() const { return covered; } // every n <= limit() is answered from the table, 0 if none is open
+
+	unsigned __int128 sumUpTo(std::uint64_t n) const // sum of the primes <= n, for n <= limit()
+	{
+		if (n < 2)
+		{
+			return 0;
+		}
+		const std::uint64_t index = (n - 1) / 2; // odd index of the largest odd number <= n
+		const std::uint64_t s = index / (PRIME_TABLE_STRIDE / 2); // not n / stride: that sample is past n - 1 for an even n on a sample
+		unsigned __int128 sum = (static_cast<unsigned __int128>(samples[2 * s + 1]) << 64) | samples[2 * s];
+		const std::uint64_t last = index / 64;
+		for (std::uint64_t w = s * (PRIME_TABLE_STRIDE / 128); w < last; w++)
+		{
+			sum += wordPrimeSum(64 * w, bits[w]);
+		}
+		const std::uint64_t bit = index % 64;
+		return sum + wordPrimeSum(64 * last, bits[last] & ((bit == 63) ? ~std::uint64_t(0) : (std::uint64_t(2) << bit) - 1));
+	}
+
+private:
+	void* mapping = nullptr;
+	std::uint64_t mappedBytes = 0;
+	std::uint64_t covered = 0;
+	const std::uint64_t* samples = nullptr; // low and high half of every sample
+	const std::uint64_t* bits = nullptr;
+};
+
+#endif // PRIME_TABLE_H
@@ -6,6 +6,12 @@ Date: 10-11-2024
 Description: Running John Conway's Game of Life using Multithreading methods. This function takes in command line arguments
 for the window height, width, pixel size, number of threads and which type of threading to use. 
 Three methods are implemented: Sequential processing, Multithreading using std::thread and Multithreading using OpenMP.
+Every generation is also recorded into a bounded XOR-delta history so a run can be paused (Space) and rewound or
+replayed (Left/Right one generation, PageUp/PageDown 100 generations, Home/End oldest/newest) while paused.
+Resuming from an older generation continues the simulation from that point.
+With -r, every Nth generation (-e) is streamed to a compressed archive by a background writer thread.
+With -a, a multi-state rule (Brian's Brain, Star Wars, Wireworld or any Generations rule) is run instead of Life on
+bit-sliced 2-bit/4-bit cells, and states are drawn with a palette. History and recording apply to Life only.
 */
 
 #include <SFML/Graphics.hpp>
@@ -16,8 +22,13 @@ Three methods are implemented: Sequential processing, Multithreading using std::
 #include <chrono>
 #include <thread>
 #include <vector>
+#include <algorithm>
 #include <omp.h>
 #include<cstring>
+#include "lifeHistory.h"
+#include "frameRecorder.h"
+#include "multiStateAutomaton.h"
+#include <memory>
 
 //Global variables
 int WINDOW_WIDTH = 800;
@@ -27,8 +38,11 @@ int GRID_WIDTH = WINDOW_WIDTH / PIXEL_SIZE;
 int GRID_HEIGHT = WINDOW_HEIGHT / PIXEL_SIZE;
 int NUM_OF_THREADS = 8;
 std::string processingType = "SEQ";  
-
-using Grid = std::vector<std::vector<bool>>; //creating a boolean vector of vectors
+int HISTORY_GENERATIONS = 1000; //number of generations kept for rewinding (0 disables the history)
+int HISTORY_MEGABYTES = 64; //memory budget of the history in megabytes
+std::string recordPath; //archive to stream generations into (empty disables recording)
+int RECORD_INTERVAL = 1; //record every Nth generation
+std::string ruleName = "LIFE"; //LIFE or a multi-state rule understood by parseMultiStateRule
 
 void seedRandomGrid(Grid& grid) //Randomly seed the array to start the game; input is the reference to the vector
 {
@@ -172,11 +186,103 @@ void parseArguments(int argc, char* argv[]) {
         else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
             NUM_OF_THREADS = std::atoi(argv[++i]); // Get the next argument as number of threads
         }
+        else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) {
+            HISTORY_GENERATIONS = std::atoi(argv[++i]); // Get the next argument as history length in generations
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            HISTORY_MEGABYTES = std::atoi(argv[++i]); // Get the next argument as history memory budget
+        }
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            recordPath = argv[++i]; // Get the next argument as the recording archive path
+        }
+        else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+            RECORD_INTERVAL = std::atoi(argv[++i]); // Get the next argument as the recording interval
+        }
+        else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+            ruleName = argv[++i]; // Get the next argument as the automaton rule
+        }
     }
     GRID_WIDTH = WINDOW_WIDTH / PIXEL_SIZE; //update grid sizes
     GRID_HEIGHT = WINDOW_HEIGHT / PIXEL_SIZE;
 }
 
+std::vector<sf::Color> buildPalette(const MultiStateRule& rule) //Colour for every state of a multi-state rule
+{
+    if (rule.family == RuleFamily::WIREWORLD)
+    {
+        return { sf::Color::Black, sf::Color(0, 128, 255), sf::Color(255, 64, 0), sf::Color(255, 200, 0) }; //empty, head, tail, conductor
+    }
+
+    std::vector<sf::Color> palette = { sf::Color::Black, sf::Color::White };
+    for (int s = 2; s < rule.states; ++s) //dying states fade from light blue towards black
+    {
+        int level = 255 - (s - 2) * 200 / std::max(1, rule.states - 2);
+        palette.push_back(sf::Color(0, static_cast<sf::Uint8>(level / 2), static_cast<sf::Uint8>(level)));
+    }
+    return palette;
+}
+
+void runMultiStateAutomaton(sf::RenderWindow& window, const MultiStateRule& rule) //Main loop for multi-state rules
+{
+    MultiStateAutomaton automaton(GRID_WIDTH, GRID_HEIGHT, rule);
+    automaton.seedRandom(static_cast<unsigned>(std::time(nullptr)));
+    std::vector<sf::Color> palette = buildPalette(rule);
+
+    double time100Gen = 0.0;
+    unsigned long numGenerations = 0;
+    while (window.isOpen())
+    {
+        sf::Event event;
+        while (window.pollEvent(event))
+        {
+            if (event.type == sf::Event::Closed)
+            {
+                window.close();
+            }
+        }
+
+        auto t_start = std::chrono::high_resolution_clock::now();
+        if (processingType == "THRD")
+        {
+            automaton.updateTHRD(NUM_OF_THREADS);
+        }
+        else if (processingType == "OMP")
+        {
+            automaton.updateOMP();
+        }
+        else
+        {
+            automaton.updateSEQ();
+        }
+        std::chrono::duration<double, std::micro> duration = std::chrono::high_resolution_clock::now() - t_start;
+        time100Gen += duration.count();
+
+        if (numGenerations % 100 == 0 && numGenerations != 0) //For every 100 Generations
+        {
+            std::cout << "Time for 100 generations: " << time100Gen << " microseconds (" << automaton.bitsPerCell() << "-bit cells)" << std::endl;
+            time100Gen = 0.0;
+        }
+        numGenerations++;
+
+        window.clear();
+        for (int x = 0; x < GRID_WIDTH; ++x) //Render each non-empty cell with its state colour
+        {
+            for (int y = 0; y < GRID_HEIGHT; ++y)
+            {
+                int state = automaton.state(x, y);
+                if (state != 0)
+                {
+                    sf::RectangleShape cell(sf::Vector2f(PIXEL_SIZE, PIXEL_SIZE));
+                    cell.setPosition(x * PIXEL_SIZE, y * PIXEL_SIZE);
+                    cell.setFillColor(palette[state]);
+                    window.draw(cell);
+                }
+            }
+        }
+        window.display();
+    }
+}
+
 int main(int argc, char* argv[])
 {
     sf::RenderWindow window(sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), "Game of Life");
@@ -193,16 +299,48 @@ int main(int argc, char* argv[])
     std::cout << PIXEL_SIZE << std::endl;
     */
 
+    if (ruleName != "LIFE")
+    {
+        MultiStateRule rule;
+        if (!parseMultiStateRule(ruleName, rule))
+        {
+            std::cerr << "Unknown rule " << ruleName << ". Use LIFE, BRAIN, STARWARS, WIREWORLD or B<digits>/S<digits>/C<states>." << std::endl;
+            return 1;
+        }
+        runMultiStateAutomaton(window, rule);
+        return 0;
+    }
+
     Grid grid_current(GRID_WIDTH, std::vector<bool>(GRID_HEIGHT, false));  // Initialize the arrays
     Grid grid_next(GRID_WIDTH, std::vector<bool>(GRID_HEIGHT, false));
 
     seedRandomGrid(grid_current); //Random instantiation
 
+    LifeHistory history(HISTORY_GENERATIONS, static_cast<size_t>(HISTORY_MEGABYTES) << 20);
+    Grid grid_view(GRID_WIDTH, std::vector<bool>(GRID_HEIGHT, false)); //generation shown while paused
+    bool paused = false;
+
+    std::unique_ptr<FrameRecorder> recorder;
+    if (!recordPath.empty())
+    {
+        recorder = std::make_unique<FrameRecorder>(recordPath, GRID_WIDTH, GRID_HEIGHT, RECORD_INTERVAL);
+        if (!recorder->isOpen())
+        {
+            std::cerr << "Could not open " << recordPath << " for recording" << std::endl;
+            recorder.reset();
+        }
+    }
+    if (HISTORY_GENERATIONS > 0)
+    {
+        history.record(grid_current);
+    }
+
     std::chrono::duration<double, std::micro> duration; //variables to calculate the time taken
     auto t_start = std::chrono::high_resolution_clock::now();
     auto t_stop = std::chrono::high_resolution_clock::now();
     double time100Gen = 0.0;
-    unsigned long numGenerations = 0;
+    unsigned long numGenerations = 0; //generations computed, for the timing printout
+    unsigned long generation = 0; //generation number of grid_current, as numbered by the history
 
     while (window.isOpen())
     {
@@ -213,6 +351,58 @@ int main(int argc, char* argv[])
             {
                 window.close();
             }
+            else if (event.type == sf::Event::KeyPressed && HISTORY_GENERATIONS > 0)
+            {
+                if (event.key.code == sf::Keyboard::Space)
+                {
+                    paused = !paused;
+                    if (!paused && !history.atHead()) //resume from the generation being viewed
+                    {
+                        history.truncateToCursor();
+                        history.viewGrid(grid_current);
+                        generation = history.cursorGeneration(); //the run continues from here, so do its numbers
+                    }
+                }
+                else if (paused)
+                {
+                    switch (event.key.code)
+                    {
+                    case sf::Keyboard::Left: history.stepBack(); break;
+                    case sf::Keyboard::Right: history.stepForward(); break;
+                    case sf::Keyboard::PageUp: history.seek(history.cursorGeneration() > 100 ? history.cursorGeneration() - 100 : 0); break;
+                    case sf::Keyboard::PageDown: history.seek(history.cursorGeneration() + 100); break;
+                    case sf::Keyboard::Home: history.seek(history.oldestGeneration()); break;
+                    case sf::Keyboard::End: history.seek(history.newestGeneration()); break;
+                    default: break;
+                    }
+                }
+                if (paused)
+                {
+                    history.viewGrid(grid_view);
+                    std::cout << "Viewing generation " << history.cursorGeneration() << " (stored " << history.oldestGeneration()
+                        << " to " << history.newestGeneration() << ", " << history.memoryBytes() / 1024 << " KB)" << std::endl;
+                }
+            }
+        }
+
+        if (paused)
+        {
+            window.clear();
+            for (int x = 0; x < GRID_WIDTH; ++x) //Render the generation selected in the history
+            {
+                for (int y = 0; y < GRID_HEIGHT; ++y)
+                {
+                    if (grid_view[x][y])
+                    {
+                        sf::RectangleShape cell(sf::Vector2f(PIXEL_SIZE, PIXEL_SIZE));
+                        cell.setPosition(x * PIXEL_SIZE, y * PIXEL_SIZE);
+                        cell.setFillColor(sf::Color::White);
+                        window.draw(cell);
+                    }
+                }
+            }
+            window.display();
+            continue;
         }
 
         if (processingType == "SEQ")  //For sequential processing
@@ -241,6 +431,16 @@ int main(int argc, char* argv[])
         }
         
         std::swap(grid_current, grid_next);  // Just swap the grids to avoid copying
+        generation++;
+
+        if (HISTORY_GENERATIONS > 0)
+        {
+            history.record(grid_current);
+        }
+        if (recorder)
+        {
+            recorder->offer(grid_current, generation);
+        }
 
         if (numGenerations % 100 == 0 && numGenerations != 0) //For every 100 Generations
         {
@@ -269,5 +469,12 @@ int main(int argc, char* argv[])
         window.display();
     }
 
+    if (recorder)
+    {
+        unsigned long dropped = recorder->droppedFrames();
+        recorder.reset(); //flushes the queue and writes the index footer
+        std::cout << "Recording finished, " << dropped << " frames dropped" << std::endl;
+    }
+
     return 0;
 }
@@ -0,0 +1,255 @@
+/*
+Author: Kamya Hari
+Class: ECE 6122
+Last Date Modified: 10-18-2026
+
+Description: Implementation of the asynchronous compressed frame recorder and its archive reader.
+*/
+
+#include "frameRecorder.h"
+#include <chrono>
+#include <cstring>
+
+namespace
+{
+    const char headerMagic[8] = { 'L', 'I', 'F', 'E', 'R', 'E', 'C', '1' };
+    const char footerMagic[8] = { 'L', 'I', 'F', 'E', 'I', 'D', 'X', '1' };
+
+    template <typename T>
+    void writeValue(std::ofstream& out, T value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    bool readValue(std::ifstream& in, T& value)
+    {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+}
+
+// PackBits: control byte c < 128 is followed by c + 1 literal bytes, c > 128 repeats the next byte 257 - c times
+void packBitsCompress(const std::uint8_t* data, size_t size, std::vector<std::uint8_t>& out)
+{
+    out.clear();
+    size_t i = 0;
+    while (i < size)
+    {
+        size_t run = 1;
+        while (i + run < size && run < 128 && data[i + run] == data[i])
+        {
+            ++run;
+        }
+        if (run >= 3)
+        {
+            out.push_back(static_cast<std::uint8_t>(257 - run));
+            out.push_back(data[i]);
+            i += run;
+            continue;
+        }
+
+        size_t start = i;
+        size_t literal = 0;
+        while (i < size && literal < 128)
+        {
+            if (i + 2 < size && data[i] == data[i + 1] && data[i] == data[i + 2])
+            {
+                break; //a run starts here, let the next iteration encode it
+            }
+            ++i;
+            ++literal;
+        }
+        out.push_back(static_cast<std::uint8_t>(literal - 1));
+        out.insert(out.end(), data + start, data + start + literal);
+    }
+}
+
+bool packBitsDecompress(const std::uint8_t* data, size_t size, std::uint8_t* out, size_t outSize)
+{
+    size_t i = 0, o = 0;
+    while (i < size)
+    {
+        std::uint8_t control = data[i++];
+        if (control < 128)
+        {
+            size_t literal = control + 1u;
+            if (i + literal > size || o + literal > outSize)
+            {
+                return false;
+            }
+            std::memcpy(out + o, data + i, literal);
+            i += literal;
+            o += literal;
+        }
+        else if (control > 128)
+        {
+            size_t run = 257u - control;
+            if (i >= size || o + run > outSize)
+            {
+                return false;
+            }
+            std::memset(out + o, data[i++], run);
+            o += run;
+        }
+    }
+    return o == outSize;
+}
+
+FrameRecorder::FrameRecorder(const std::string& path, int width, int height, int interval, size_t queueSlots)
+    : archive(path, std::ios::binary | std::ios::trunc), interval(interval > 0 ? interval : 1), slots(queueSlots + 1)
+{
+    archiveOk = static_cast<bool>(archive);
+    if (!archiveOk)
+    {
+        return;
+    }
+    for (auto& slot : slots)
+    {
+        slot.words.reserve(packedWordCount(width, height)); //no allocations on the simulation thread after start-up
+    }
+
+    archive.write(headerMagic, sizeof(headerMagic));
+    writeValue<std::uint32_t>(archive, width);
+    writeValue<std::uint32_t>(archive, height);
+    writeValue<std::uint32_t>(archive, this->interval);
+    writeValue<std::uint32_t>(archive, 0);
+
+    writer = std::thread(&FrameRecorder::writerLoop, this);
+}
+
+FrameRecorder::~FrameRecorder()
+{
+    if (!archiveOk)
+    {
+        return;
+    }
+    stopping.store(true, std::memory_order_release);
+    writer.join();
+
+    std::uint64_t indexOffset = static_cast<std::uint64_t>(archive.tellp());
+    for (const auto& entry : index)
+    {
+        writeValue(archive, entry.generation);
+        writeValue(archive, entry.offset);
+        writeValue(archive, entry.bytes);
+    }
+    writeValue<std::uint64_t>(archive, index.size());
+    writeValue(archive, indexOffset);
+    archive.write(footerMagic, sizeof(footerMagic));
+}
+
+void FrameRecorder::offer(const Grid& grid, unsigned long generation)
+{
+    if (!archiveOk || generation % interval != 0)
+    {
+        return;
+    }
+
+    size_t current = head.load(std::memory_order_relaxed);
+    size_t next = (current + 1) % slots.size();
+    if (next == tail.load(std::memory_order_acquire))
+    {
+        dropped.fetch_add(1, std::memory_order_relaxed); //writer is behind: drop instead of waiting
+        return;
+    }
+
+    slots[current].generation = generation;
+    packGrid(grid, slots[current].words);
+    head.store(next, std::memory_order_release);
+}
+
+void FrameRecorder::writerLoop()
+{
+    while (true)
+    {
+        size_t current = tail.load(std::memory_order_relaxed);
+        if (current == head.load(std::memory_order_acquire))
+        {
+            if (stopping.load(std::memory_order_acquire) && current == head.load(std::memory_order_acquire))
+            {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        writeFrame(slots[current]);
+        tail.store((current + 1) % slots.size(), std::memory_order_release);
+    }
+    archive.flush();
+}
+
+void FrameRecorder::writeFrame(const Slot& slot)
+{
+    packBitsCompress(reinterpret_cast<const std::uint8_t*>(slot.words.data()),
+        slot.words.size() * sizeof(std::uint64_t), compressed);
+
+    IndexEntry entry;
+    entry.generation = slot.generation;
+    entry.offset = static_cast<std::uint64_t>(archive.tellp());
+    entry.bytes = compressed.size();
+    archive.write(reinterpret_cast<const char*>(compressed.data()), compressed.size());
+    index.push_back(entry);
+    written.fetch_add(1, std::memory_order_relaxed);
+}
+
+FrameArchiveReader::FrameArchiveReader(const std::string& path)
+    : archive(path, std::ios::binary)
+{
+    char magic[8];
+    std::uint32_t width = 0, height = 0, interval = 0, reserved = 0;
+    if (!archive.read(magic, sizeof(magic)) || std::memcmp(magic, headerMagic, sizeof(magic)) != 0 ||
+        !readValue(archive, width) || !readValue(archive, height) || !readValue(archive, interval) || !readValue(archive, reserved))
+    {
+        return;
+    }
+
+    std::uint64_t count = 0, indexOffset = 0;
+    archive.seekg(-static_cast<std::streamoff>(2 * sizeof(std::uint64_t) + sizeof(footerMagic)), std::ios::end);
+    if (!readValue(archive, count) || !readValue(archive, indexOffset) ||
+        !archive.read(magic, sizeof(magic)) || std::memcmp(magic, footerMagic, sizeof(magic)) != 0)
+    {
+        return;
+    }
+
+    archive.seekg(static_cast<std::streamoff>(indexOffset));
+    for (std::uint64_t i = 0; i < count; ++i)
+    {
+        std::uint64_t generation, offset, bytes;
+        if (!readValue(archive, generation) || !readValue(archive, offset) || !readValue(archive, bytes))
+        {
+            return;
+        }
+        generations.push_back(static_cast<unsigned long>(generation));
+        offsets.push_back(offset);
+        sizes.push_back(bytes);
+    }
+    gridWidth = static_cast<int>(width);
+    gridHeight = static_cast<int>(height);
+    archiveOk = true;
+}
+
+bool FrameArchiveReader::readFrame(size_t frame, Grid& grid)
+{
+    if (!archiveOk || frame >= offsets.size())
+    {
+        return false;
+    }
+
+    std::vector<std::uint8_t> compressed(sizes[frame]);
+    archive.clear();
+    archive.seekg(static_cast<std::streamoff>(offsets[frame]));
+    if (!archive.read(reinterpret_cast<char*>(compressed.data()), compressed.size()))
+    {
+        return false;
+    }
+
+    PackedGrid words(packedWordCount(gridWidth, gridHeight));
+    if (!packBitsDecompress(compressed.data(), compressed.size(),
+        reinterpret_cast<std::uint8_t*>(words.data()), words.size() * sizeof(std::uint64_t)))
+    {
+        return false;
+    }
+    unpackGrid(words, grid);
+    return true;
+}
@@ -0,0 +1,96 @@
+/*
+Author: Kamya Hari
+Class: ECE 6122
+Last Date Modified: 10-18-2026
+
+Description: Asynchronous recorder that streams every Nth Game of Life generation to a single archive file.
+The simulation thread bit-packs the grid into a preallocated slot of a single-producer/single-consumer lock-free
+ring and returns immediately; a background writer thread PackBits-compresses the slots and appends them to the
+archive. If the writer falls behind, frames are dropped and counted rather than stalling the simulation.
+
+Archive layout (native byte order):
+    header: "LIFEREC1", uint32 width, uint32 height, uint32 interval, uint32 reserved
+    frames: PackBits-compressed bit-packed grids (see gridPacking.h for the bit order)
+    index:  per frame {uint64 generation, uint64 offset, uint64 compressed size}
+    footer: uint64 frame count, uint64 index offset, "LIFEIDX1"
+*/
+
+#ifndef FRAME_RECORDER_H
+#define FRAME_RECORDER_H
+
+#include "gridPacking.h"
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+class FrameRecorder
+{
+public:
+    FrameRecorder(const std::string& path, int width, int height, int interval, size_t queueSlots = 64);
+    ~FrameRecorder(); //drains the queue, writes the index footer and closes the archive
+
+    bool isOpen() const { return archiveOk; }
+    void offer(const Grid& grid, unsigned long generation); //records the grid if generation is a multiple of the interval; never blocks
+    unsigned long recordedFrames() const { return written.load(); }
+    unsigned long droppedFrames() const { return dropped.load(); }
+
+private:
+    struct Slot
+    {
+        unsigned long generation = 0;
+        PackedGrid words;
+    };
+    struct IndexEntry
+    {
+        std::uint64_t generation;
+        std::uint64_t offset;
+        std::uint64_t bytes;
+    };
+
+    void writerLoop();
+    void writeFrame(const Slot& slot);
+
+    std::ofstream archive;
+    bool archiveOk = false;
+    int interval;
+    std::vector<Slot> slots;
+    std::atomic<size_t> head{ 0 }; //next slot the simulation writes (only advanced by the producer)
+    std::atomic<size_t> tail{ 0 }; //next slot the writer reads (only advanced by the consumer)
+    std::atomic<bool> stopping{ false };
+    std::atomic<unsigned long> written{ 0 };
+    std::atomic<unsigned long> dropped{ 0 };
+    std::vector<IndexEntry> index; //only touched by the writer thread
+    std::vector<std::uint8_t> compressed; //compression buffer reused by the writer thread
+    std::thread writer;
+};
+
+// Random access to a finished archive through its index footer
+class FrameArchiveReader
+{
+public:
+    explicit FrameArchiveReader(const std::string& path);
+
+    bool isOpen() const { return archiveOk; }
+    int width() const { return gridWidth; }
+    int height() const { return gridHeight; }
+    size_t frameCount() const { return generations.size(); }
+    unsigned long generation(size_t frame) const { return generations[frame]; }
+    bool readFrame(size_t frame, Grid& grid); //grid must already be sized width x height
+
+private:
+    std::ifstream archive;
+    bool archiveOk = false;
+    int gridWidth = 0;
+    int gridHeight = 0;
+    std::vector<unsigned long> generations;
+    std::vector<std::uint64_t> offsets;
+    std::vector<std::uint64_t> sizes;
+};
+
+void packBitsCompress(const std::uint8_t* data, size_t size, std::vector<std::uint8_t>& out);
+bool packBitsDecompress(const std::uint8_t* data, size_t size, std::uint8_t* out, size_t outSize);
+
+#endif // FRAME_RECORDER_H
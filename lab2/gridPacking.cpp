@@ -0,0 +1,45 @@
+/*
+Author: Kamya Hari
+Class: ECE 6122
+Last Date Modified: 10-18-2026
+
+Description: Bit-packing helpers for the Game of Life grid.
+*/
+
+#include "gridPacking.h"
+
+size_t packedWordCount(int width, int height)
+{
+    return (static_cast<size_t>(width) * height + 63) / 64;
+}
+
+void packGrid(const Grid& grid, PackedGrid& packed)
+{
+    int width = static_cast<int>(grid.size());
+    int height = width > 0 ? static_cast<int>(grid[0].size()) : 0;
+    packed.assign(packedWordCount(width, height), 0);
+
+    size_t bit = 0;
+    for (int x = 0; x < width; ++x)
+    {
+        for (int y = 0; y < height; ++y, ++bit)
+        {
+            if (grid[x][y])
+            {
+                packed[bit >> 6] |= std::uint64_t(1) << (bit & 63);
+            }
+        }
+    }
+}
+
+void unpackGrid(const PackedGrid& packed, Grid& grid)
+{
+    size_t bit = 0;
+    for (auto& column : grid)
+    {
+        for (size_t y = 0; y < column.size(); ++y, ++bit)
+        {
+            column[y] = (packed[bit >> 6] >> (bit & 63)) & 1;
+        }
+    }
+}
@@ -0,0 +1,24 @@
+/*
+Author: Kamya Hari
+Class: ECE 6122
+Last Date Modified: 10-18-2026
+
+Description: Helpers to convert the Game of Life grid between the vector-of-vectors representation used by the
+update functions and a bit-packed array of 64-bit words. Cell (x, y) is stored at bit index x * height + y.
+*/
+
+#ifndef GRID_PACKING_H
+#define GRID_PACKING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using Grid = std::vector<std::vector<bool>>; //creating a boolean vector of vectors
+using PackedGrid = std::vector<std::uint64_t>; //bit-packed grid, 64 cells per word
+
+size_t packedWordCount(int width, int height); //number of 64-bit words needed for a width x height grid
+void packGrid(const Grid& grid, PackedGrid& packed); //resizes packed and fills it from grid
+void unpackGrid(const PackedGrid& packed, Grid& grid); //fills an already sized grid from packed
+
+#endif // GRID_PACKING_H
@@ -0,0 +1,156 @@
+/*
+Author: Kamya Hari
+Class: ECE 6122
+Last Date Modified: 10-18-2026
+
+Description: Implementation of the XOR-delta generation history used to rewind Game of Life runs.
+*/
+
+#include "lifeHistory.h"
+#include <utility>
+
+LifeHistory::LifeHistory(size_t maxGenerations, size_t maxBytes)
+    : maxGenerations(maxGenerations), maxBytes(maxBytes)
+{
+}
+
+void LifeHistory::applyDelta(const Delta& delta, PackedGrid& frame)
+{
+    if (delta.dense)
+    {
+        for (size_t i = 0; i < delta.words.size(); ++i)
+        {
+            frame[i] ^= delta.words[i];
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < delta.index.size(); ++i)
+        {
+            frame[delta.index[i]] ^= delta.words[i];
+        }
+    }
+}
+
+void LifeHistory::encodeDelta(const PackedGrid& older, const PackedGrid& newer, Delta& delta) const
+{
+    size_t changed = 0;
+    for (size_t i = 0; i < newer.size(); ++i)
+    {
+        changed += (older[i] != newer[i]);
+    }
+
+    // A sparse entry costs 12 bytes against 8 for a dense word, so only go sparse below two thirds changed
+    delta.dense = changed * 3 > newer.size() * 2;
+    delta.index.clear();
+    delta.words.clear();
+    if (delta.dense)
+    {
+        delta.words.resize(newer.size());
+        for (size_t i = 0; i < newer.size(); ++i)
+        {
+            delta.words[i] = older[i] ^ newer[i];
+        }
+    }
+    else
+    {
+        delta.index.reserve(changed);
+        delta.words.reserve(changed);
+        for (size_t i = 0; i < newer.size(); ++i)
+        {
+            if (older[i] != newer[i])
+            {
+                delta.index.push_back(static_cast<std::uint32_t>(i));
+                delta.words.push_back(older[i] ^ newer[i]);
+            }
+        }
+    }
+}
+
+void LifeHistory::evictOldest()
+{
+    if (cursor == oldestGeneration())
+    {
+        applyDelta(deltas.front(), view); //keep the cursor on a generation that is still stored
+        ++cursor;
+    }
+    deltaBytes -= deltas.front().bytes();
+    deltas.pop_front();
+}
+
+void LifeHistory::record(const Grid& grid)
+{
+    if (!atHead())
+    {
+        truncateToCursor();
+    }
+
+    packGrid(grid, scratch);
+    if (generationCount == 0 || maxGenerations == 0)
+    {
+        head.swap(scratch);
+    }
+    else
+    {
+        deltas.emplace_back();
+        encodeDelta(head, scratch, deltas.back());
+        deltaBytes += deltas.back().bytes();
+        head.swap(scratch);
+    }
+    ++generationCount;
+    view = head;
+    cursor = newestGeneration();
+
+    while (!deltas.empty() && (deltas.size() > maxGenerations || memoryBytes() > maxBytes))
+    {
+        evictOldest();
+    }
+}
+
+void LifeHistory::truncateToCursor()
+{
+    while (cursor < newestGeneration())
+    {
+        deltaBytes -= deltas.back().bytes();
+        deltas.pop_back();
+        --generationCount;
+    }
+    head = view;
+}
+
+bool LifeHistory::stepBack()
+{
+    if (empty() || cursor == oldestGeneration())
+    {
+        return false;
+    }
+    applyDelta(deltas[cursor - 1 - oldestGeneration()], view);
+    --cursor;
+    return true;
+}
+
+bool LifeHistory::stepForward()
+{
+    if (empty() || atHead())
+    {
+        return false;
+    }
+    applyDelta(deltas[cursor - oldestGeneration()], view);
+    ++cursor;
+    return true;
+}
+
+void LifeHistory::seek(unsigned long generation)
+{
+    while (cursor > generation && stepBack())
+    {
+    }
+    while (cursor < generation && stepForward())
+    {
+    }
+}
+
+void LifeHistory::viewGrid(Grid& grid) const
+{
+    unpackGrid(view, grid);
+}
@@ -0,0 +1,67 @@
+/*
+Author: Kamya Hari
+Class: ECE 6122
+Last Date Modified: 10-18-2026
+
+Description: Bounded history of Game of Life generations. The newest generation is kept as a full bit-packed frame
+and every older generation is stored as the XOR delta to its successor, encoded as a sparse list of the words that
+changed (or as a dense word array when most words changed). A cursor can be moved backward and forward through the
+stored generations by applying one delta per step. The oldest deltas are dropped once either the generation limit
+or the byte budget is exceeded, so the memory footprint stays fixed for arbitrarily long runs.
+*/
+
+#ifndef LIFE_HISTORY_H
+#define LIFE_HISTORY_H
+
+#include "gridPacking.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+class LifeHistory
+{
+public:
+    LifeHistory(size_t maxGenerations, size_t maxBytes);
+
+    void record(const Grid& grid); //append a new newest generation; moves the cursor to it
+    void truncateToCursor(); //forget every generation newer than the cursor (used when resuming from the past)
+
+    bool stepBack(); //move the cursor one generation back; returns false at the oldest stored generation
+    bool stepForward(); //move the cursor one generation forward; returns false at the newest generation
+    void seek(unsigned long generation); //move the cursor to a generation, clamped to the stored range
+
+    void viewGrid(Grid& grid) const; //unpack the generation under the cursor into an already sized grid
+
+    bool empty() const { return generationCount == 0; }
+    bool atHead() const { return cursor == newestGeneration(); }
+    unsigned long oldestGeneration() const { return newestGeneration() - deltas.size(); }
+    unsigned long newestGeneration() const { return generationCount == 0 ? 0 : generationCount - 1; }
+    unsigned long cursorGeneration() const { return cursor; }
+    size_t memoryBytes() const { return deltaBytes + 2 * head.size() * sizeof(std::uint64_t); }
+
+private:
+    struct Delta
+    {
+        bool dense = false; //true: words holds the full XOR frame; false: words[i] belongs at index[i]
+        std::vector<std::uint32_t> index;
+        std::vector<std::uint64_t> words;
+        size_t bytes() const { return index.size() * sizeof(std::uint32_t) + words.size() * sizeof(std::uint64_t); }
+    };
+
+    static void applyDelta(const Delta& delta, PackedGrid& frame); //XOR is its own inverse, so this works both ways
+    void encodeDelta(const PackedGrid& older, const PackedGrid& newer, Delta& delta) const;
+    void evictOldest();
+
+    size_t maxGenerations;
+    size_t maxBytes;
+    std::deque<Delta> deltas; //deltas[i] turns generation (oldest + i) into (oldest + i + 1)
+    PackedGrid head; //newest generation
+    PackedGrid scratch; //packing buffer reused between records
+    PackedGrid view; //generation under the cursor
+    unsigned long generationCount = 0;
+    unsigned long cursor = 0;
+    size_t deltaBytes = 0;
+};
+
+#endif // LIFE_HISTORY_H
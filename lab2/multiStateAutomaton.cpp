@@ -0,0 +1,324 @@
+/*
+Author: Kamya Hari
+Class: ECE 6122
+Last Date Modified: 10-18-2026
+
+Description: Bit-sliced update of multi-state cellular automata.
+*/
+
+#include "multiStateAutomaton.h"
+#include <cstdlib>
+#include <thread>
+
+namespace
+{
+    const std::uint64_t ALL = ~std::uint64_t(0);
+
+    // Mask of the cells whose bit-sliced value equals 'value'
+    std::uint64_t equalsMask(const std::uint64_t* bits, int numBits, unsigned value)
+    {
+        std::uint64_t mask = ALL;
+        for (int k = 0; k < numBits; ++k)
+        {
+            mask &= ((value >> k) & 1) ? bits[k] : ~bits[k];
+        }
+        return mask;
+    }
+
+    // Mask of the cells whose 4-bit neighbor count is in the set 'counts' (bit n = count n)
+    std::uint64_t countInSet(const std::uint64_t* count, unsigned counts)
+    {
+        std::uint64_t mask = 0;
+        for (unsigned n = 0; n <= 8; ++n)
+        {
+            if ((counts >> n) & 1)
+            {
+                mask |= equalsMask(count, 4, n);
+            }
+        }
+        return mask;
+    }
+
+    // Parses "<prefix><digits 0-8>" at pos, e.g. "B36"; sets bit n of set for every digit n
+    bool parseCountSet(const std::string& text, size_t& pos, char prefix, unsigned& set)
+    {
+        if (pos >= text.size() || text[pos] != prefix)
+        {
+            return false;
+        }
+        ++pos;
+        set = 0;
+        while (pos < text.size() && text[pos] >= '0' && text[pos] <= '8')
+        {
+            set |= 1u << (text[pos++] - '0');
+        }
+        return true;
+    }
+}
+
+bool parseMultiStateRule(const std::string& text, MultiStateRule& rule)
+{
+    if (text == "BRAIN")
+    {
+        return parseMultiStateRule("B2/S/C3", rule);
+    }
+    if (text == "STARWARS")
+    {
+        return parseMultiStateRule("B2/S345/C4", rule);
+    }
+    if (text == "WIREWORLD")
+    {
+        rule = MultiStateRule();
+        rule.family = RuleFamily::WIREWORLD;
+        rule.states = 4;
+        return true;
+    }
+
+    // Generations notation B<digits>/S<digits>/C<states>
+    size_t pos = 0;
+    MultiStateRule parsed;
+    if (!parseCountSet(text, pos, 'B', parsed.birth) || pos >= text.size() || text[pos++] != '/' ||
+        !parseCountSet(text, pos, 'S', parsed.survival) || pos >= text.size() || text[pos++] != '/' ||
+        pos >= text.size() || text[pos++] != 'C')
+    {
+        return false;
+    }
+    parsed.states = std::atoi(text.c_str() + pos);
+    if (parsed.states < 2 || parsed.states > 16 || (parsed.birth & 1))
+    {
+        return false; //B0 would need the complement trick, which this engine does not implement
+    }
+    rule = parsed;
+    return true;
+}
+
+MultiStateAutomaton::MultiStateAutomaton(int width, int height, const MultiStateRule& rule)
+    : rule(rule), width(width), height(height), wordsPerRow((width + 63) / 64), numPlanes(rule.states <= 4 ? 2 : 4)
+{
+    lastWordMask = (width % 64 == 0) ? ALL : ((std::uint64_t(1) << (width % 64)) - 1);
+    current.assign(static_cast<size_t>(numPlanes) * height * wordsPerRow, 0);
+    next = current;
+}
+
+int MultiStateAutomaton::state(int x, int y) const
+{
+    int value = 0;
+    for (int p = 0; p < numPlanes; ++p)
+    {
+        value |= static_cast<int>((plane(current, p, y)[x >> 6] >> (x & 63)) & 1) << p;
+    }
+    return value;
+}
+
+void MultiStateAutomaton::setState(int x, int y, int value)
+{
+    for (int p = 0; p < numPlanes; ++p)
+    {
+        std::uint64_t bit = std::uint64_t(1) << (x & 63);
+        std::uint64_t& word = plane(current, p, y)[x >> 6];
+        word = ((value >> p) & 1) ? (word | bit) : (word & ~bit);
+    }
+}
+
+void MultiStateAutomaton::seedRandom(unsigned seed)
+{
+    std::srand(seed);
+    if (rule.family == RuleFamily::GENERATIONS)
+    {
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                setState(x, y, (std::rand() % 3 == 0) ? 1 : 0); // Randomly seed a third of the cells alive
+            }
+        }
+        return;
+    }
+
+    // Wireworld: random rectangular conductor loops, each carrying one electron
+    int loops = (width * height) / 400 + 1;
+    for (int i = 0; i < loops; ++i)
+    {
+        int w = 4 + std::rand() % 20, h = 4 + std::rand() % 20;
+        int x0 = std::rand() % width, y0 = std::rand() % height;
+        for (int dx = 0; dx <= w; ++dx)
+        {
+            setState((x0 + dx) % width, y0, 3);
+            setState((x0 + dx) % width, (y0 + h) % height, 3);
+        }
+        for (int dy = 0; dy <= h; ++dy)
+        {
+            setState(x0, (y0 + dy) % height, 3);
+            setState((x0 + w) % width, (y0 + dy) % height, 3);
+        }
+        setState((x0 + 2) % width, y0, 1); // electron head followed by its tail
+        setState((x0 + 1) % width, y0, 2);
+    }
+}
+
+void MultiStateAutomaton::allocateBuffers(RowBuffers& buffers) const
+{
+    for (int r = 0; r < 3; ++r)
+    {
+        buffers.rows[r].assign(wordsPerRow, 0);
+        buffers.west[r].assign(wordsPerRow, 0);
+        buffers.east[r].assign(wordsPerRow, 0);
+    }
+}
+
+void MultiStateAutomaton::liveMaskRow(int y, std::vector<std::uint64_t>& out) const
+{
+    std::uint64_t bits[4];
+    for (int w = 0; w < wordsPerRow; ++w)
+    {
+        for (int p = 0; p < numPlanes; ++p)
+        {
+            bits[p] = plane(current, p, y)[w];
+        }
+        out[w] = equalsMask(bits, numPlanes, 1);
+    }
+    out[wordsPerRow - 1] &= lastWordMask;
+}
+
+void MultiStateAutomaton::shiftEast(const std::vector<std::uint64_t>& in, std::vector<std::uint64_t>& out) const
+{
+    for (int w = 0; w < wordsPerRow; ++w)
+    {
+        out[w] = (in[w] << 1) | (w > 0 ? in[w - 1] >> 63 : 0);
+    }
+    out[0] |= (in[(width - 1) >> 6] >> ((width - 1) & 63)) & 1; // torus wrap: cell 0 sees cell width - 1
+    out[wordsPerRow - 1] &= lastWordMask;
+}
+
+void MultiStateAutomaton::shiftWest(const std::vector<std::uint64_t>& in, std::vector<std::uint64_t>& out) const
+{
+    for (int w = 0; w < wordsPerRow; ++w)
+    {
+        out[w] = (in[w] >> 1) | (w + 1 < wordsPerRow ? in[w + 1] << 63 : 0);
+    }
+    out[wordsPerRow - 1] |= (in[0] & 1) << ((width - 1) & 63); // torus wrap: cell width - 1 sees cell 0
+    out[wordsPerRow - 1] &= lastWordMask;
+}
+
+void MultiStateAutomaton::updateRow(int y, RowBuffers& buffers)
+{
+    int rowIndex[3] = { (y - 1 + height) % height, y, (y + 1) % height };
+    for (int r = 0; r < 3; ++r)
+    {
+        liveMaskRow(rowIndex[r], buffers.rows[r]);
+        shiftEast(buffers.rows[r], buffers.east[r]);
+        shiftWest(buffers.rows[r], buffers.west[r]);
+    }
+
+    for (int w = 0; w < wordsPerRow; ++w)
+    {
+        const std::uint64_t neighbors[8] = {
+            buffers.west[0][w], buffers.rows[0][w], buffers.east[0][w],
+            buffers.west[1][w], buffers.east[1][w],
+            buffers.west[2][w], buffers.rows[2][w], buffers.east[2][w] };
+
+        // Bit-sliced ripple adder: count[k] holds bit k of the live neighbor count of each of the 64 cells
+        std::uint64_t count[4] = { 0, 0, 0, 0 };
+        for (std::uint64_t carry : neighbors)
+        {
+            for (int k = 0; k < 4 && carry; ++k)
+            {
+                std::uint64_t overflow = count[k] & carry;
+                count[k] ^= carry;
+                carry = overflow;
+            }
+        }
+
+        std::uint64_t s[4] = { 0, 0, 0, 0 };
+        for (int p = 0; p < numPlanes; ++p)
+        {
+            s[p] = plane(current, p, y)[w];
+        }
+
+        std::uint64_t out[4] = { 0, 0, 0, 0 };
+        if (rule.family == RuleFamily::WIREWORLD)
+        {
+            std::uint64_t head = s[0] & ~s[1], tail = ~s[0] & s[1], conductor = s[0] & s[1];
+            std::uint64_t oneOrTwo = ~count[3] & ~count[2] & (count[0] ^ count[1]);
+            out[0] = tail | conductor; // tail -> conductor, conductor -> conductor or head
+            out[1] = head | tail | (conductor & ~oneOrTwo); // head -> tail, conductor stays unless it fires
+        }
+        else
+        {
+            std::uint64_t dead = equalsMask(s, numPlanes, 0);
+            std::uint64_t alive = equalsMask(s, numPlanes, 1);
+            std::uint64_t born = dead & countInSet(count, rule.birth);
+            std::uint64_t survive = alive & countInSet(count, rule.survival);
+            std::uint64_t aging = ~dead & ~survive; // live cells that die and dying cells advance one state
+
+            // Bit-sliced increment of the state, wrapping to dead once it reaches the number of states
+            std::uint64_t incremented[4];
+            std::uint64_t carry = ALL;
+            for (int p = 0; p < numPlanes; ++p)
+            {
+                incremented[p] = s[p] ^ carry;
+                carry &= s[p];
+            }
+            std::uint64_t expired = (rule.states == (1 << numPlanes)) ? 0 : equalsMask(incremented, numPlanes, rule.states);
+            for (int p = 0; p < numPlanes; ++p)
+            {
+                out[p] = aging & ~expired & incremented[p];
+            }
+            out[0] |= born | survive;
+        }
+
+        std::uint64_t valid = (w == wordsPerRow - 1) ? lastWordMask : ALL;
+        for (int p = 0; p < numPlanes; ++p)
+        {
+            plane(next, p, y)[w] = out[p] & valid;
+        }
+    }
+}
+
+void MultiStateAutomaton::updateRows(int startRow, int endRow)
+{
+    RowBuffers buffers;
+    allocateBuffers(buffers);
+    for (int y = startRow; y < endRow; ++y)
+    {
+        updateRow(y, buffers);
+    }
+}
+
+void MultiStateAutomaton::updateSEQ()
+{
+    updateRows(0, height);
+    current.swap(next);
+}
+
+void MultiStateAutomaton::updateTHRD(int numThreads)
+{
+    std::vector<std::thread> threads;
+    int rowsPerThread = height / numThreads;
+    for (int i = 0; i < numThreads; ++i)
+    {
+        int startRow = i * rowsPerThread;
+        int endRow = (i == numThreads - 1) ? height : startRow + rowsPerThread;
+        threads.emplace_back(&MultiStateAutomaton::updateRows, this, startRow, endRow);
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    current.swap(next);
+}
+
+void MultiStateAutomaton::updateOMP()
+{
+    #pragma omp parallel
+    {
+        RowBuffers buffers;
+        allocateBuffers(buffers);
+        #pragma omp for schedule(static)
+        for (int y = 0; y < height; ++y)
+        {
+            updateRow(y, buffers);
+        }
+    }
+    current.swap(next);
+}
@@ -0,0 +1,78 @@
+/*
+Author: Kamya Hari
+Class: ECE 6122
+Last Date Modified: 10-18-2026
+
+Description: Multi-state cellular automata (Generations rules such as Brian's Brain, and Wireworld) on a torus.
+Cell states are stored bit-sliced: 2 planes (2 bits per cell) for up to 4 states, 4 planes (4 bits per cell) for up
+to 16 states. Each plane is a row-major array of 64-bit words, so the update works on 64 cells at a time: neighbor
+counts are accumulated with a bit-sliced adder and the rule is applied with bitwise logic on the state planes.
+*/
+
+#ifndef MULTI_STATE_AUTOMATON_H
+#define MULTI_STATE_AUTOMATON_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class RuleFamily { GENERATIONS, WIREWORLD };
+
+struct MultiStateRule
+{
+    RuleFamily family = RuleFamily::GENERATIONS;
+    unsigned birth = 0; //bit n set: a dead cell with n live neighbors is born (Generations only)
+    unsigned survival = 0; //bit n set: a live cell with n live neighbors survives (Generations only)
+    int states = 2; //number of states including dead; states beyond 1 are dying states
+};
+
+// Accepts BRAIN, STARWARS, WIREWORLD or Generations notation such as B2/S/C3; returns false if the text is not a rule
+bool parseMultiStateRule(const std::string& text, MultiStateRule& rule);
+
+class MultiStateAutomaton
+{
+public:
+    MultiStateAutomaton(int width, int height, const MultiStateRule& rule);
+
+    int bitsPerCell() const { return numPlanes; }
+    int state(int x, int y) const;
+    void setState(int x, int y, int value);
+    void seedRandom(unsigned seed);
+
+    void updateSEQ(); //the three update flavours mirror updateGridSEQ/THRD/OMP for binary Life
+    void updateTHRD(int numThreads);
+    void updateOMP();
+
+private:
+    struct RowBuffers //per-thread scratch rows for the neighbor masks
+    {
+        std::vector<std::uint64_t> rows[3], west[3], east[3];
+    };
+
+    const std::uint64_t* plane(const std::vector<std::uint64_t>& grid, int p, int y) const
+    {
+        return grid.data() + (static_cast<size_t>(p) * height + y) * wordsPerRow;
+    }
+    std::uint64_t* plane(std::vector<std::uint64_t>& grid, int p, int y)
+    {
+        return grid.data() + (static_cast<size_t>(p) * height + y) * wordsPerRow;
+    }
+
+    void allocateBuffers(RowBuffers& buffers) const;
+    void liveMaskRow(int y, std::vector<std::uint64_t>& out) const; //cells in state 1 (alive / electron head)
+    void shiftEast(const std::vector<std::uint64_t>& in, std::vector<std::uint64_t>& out) const; //out[x] = in[x - 1]
+    void shiftWest(const std::vector<std::uint64_t>& in, std::vector<std::uint64_t>& out) const; //out[x] = in[x + 1]
+    void updateRow(int y, RowBuffers& buffers);
+    void updateRows(int startRow, int endRow);
+
+    MultiStateRule rule;
+    int width;
+    int height;
+    int wordsPerRow;
+    int numPlanes;
+    std::uint64_t lastWordMask; //valid bits of the last word in each row
+    std::vector<std::uint64_t> current; //[plane][row][word]
+    std::vector<std::uint64_t> next;
+};
+
+#endif // MULTI_STATE_AUTOMATON_H
@@ -4,11 +4,12 @@ Class: ECE6122 A
 Last Date Modified: 11/08/2024
 Description:
 Generate a common enum class for different memory types
+CPU selects the host backend, which needs no CUDA device
 */
 #ifndef COMMON_H
 #define COMMON_H
 
 // Enum for different memory types used in the Game of Life simulation
-enum MemoryType { NORMAL, PINNED, MANAGED };
+enum MemoryType { NORMAL, PINNED, MANAGED, CPU };
 
 #endif // COMMON_H
\ No newline at end of file
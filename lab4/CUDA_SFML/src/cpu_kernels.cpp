@@ -0,0 +1,95 @@
+/*
+Author: Kamya Hari
+Class: ECE6122 A
+Last Date Modified: 10/18/2026
+Description:
+Host implementation of the Game of Life update. It applies exactly the rule of updateGameOfLifeKernel: cells outside
+the grid count as dead (no wrap-around). Each thread handles a band of rows; a row is processed by first summing the
+three vertical neighbors of every column into a zero-padded buffer and then adding adjacent column sums, which keeps
+the inner loops branch-free byte arithmetic that the compiler vectorizes.
+*/
+
+#include "cpu_kernels.h"
+#include <cstring>
+#include <thread>
+#include <vector>
+
+static void updateRowsCPU(const unsigned char* current, unsigned char* next, int width, int height, int startRow, int endRow) {
+    std::vector<unsigned char> columnSums(width + 2, 0);  // columnSums[x + 1] = live cells in column x of rows y-1..y+1
+    unsigned char* sums = columnSums.data() + 1;
+
+    for (int y = startRow; y < endRow; ++y) {
+        const unsigned char* mid = current + static_cast<size_t>(y) * width;
+        const unsigned char* up = (y > 0) ? mid - width : nullptr;
+        const unsigned char* down = (y < height - 1) ? mid + width : nullptr;
+        unsigned char* out = next + static_cast<size_t>(y) * width;
+
+        for (int x = 0; x < width; ++x) {
+            sums[x] = mid[x];
+        }
+        if (up) {
+            for (int x = 0; x < width; ++x) {
+                sums[x] += up[x];
+            }
+        }
+        if (down) {
+            for (int x = 0; x < width; ++x) {
+                sums[x] += down[x];
+            }
+        }
+
+        // sums[-1] and sums[width] stay 0, which is the bounds check for the left and right edges
+        for (int x = 0; x < width; ++x) {
+            unsigned char count = sums[x - 1] + sums[x] + sums[x + 1] - mid[x];
+            out[x] = (count == 3) | (mid[x] & (count == 2));
+        }
+    }
+}
+
+void updateGameOfLifeCPU(const bool* currentGrid, bool* nextGrid, int width, int height, int numThreads) {
+    const unsigned char* current = reinterpret_cast<const unsigned char*>(currentGrid);
+    unsigned char* next = reinterpret_cast<unsigned char*>(nextGrid);
+
+    if (numThreads < 1) numThreads = 1;
+    if (numThreads > height) numThreads = height;
+    if (numThreads == 1) {
+        updateRowsCPU(current, next, width, height, 0, height);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    int rowsPerThread = height / numThreads;
+    for (int i = 0; i < numThreads; ++i) {
+        int startRow = i * rowsPerThread;
+        int endRow = (i == numThreads - 1) ? height : startRow + rowsPerThread;
+        threads.emplace_back(updateRowsCPU, current, next, width, height, startRow, endRow);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+namespace {
+    class HostLifeBackend : public LifeBackend {
+    public:
+        explicit HostLifeBackend(int numThreads) : numThreads(numThreads) {}
+
+        bool* allocateGrid(size_t bytes) override { return new bool[bytes](); }
+        void freeGrid(bool* grid) override { delete[] grid; }
+        bool* allocateHostMirror(size_t) override { return nullptr; }  // the grids already live in host memory
+        void freeHostMirror(bool*) override {}
+        void upload(bool* grid, const bool* host, size_t bytes) override { std::memcpy(grid, host, bytes); }
+        void download(bool* host, const bool* grid, size_t bytes) override { std::memcpy(host, grid, bytes); }
+        void update(const bool* current, bool* next, int width, int height) override {
+            updateGameOfLifeCPU(current, next, width, height, numThreads);
+        }
+        void synchronize() override {}
+
+    private:
+        int numThreads;
+    };
+}
+
+std::unique_ptr<LifeBackend> createHostBackend(int numThreads) {
+    return std::unique_ptr<LifeBackend>(new HostLifeBackend(numThreads));
+}
@@ -0,0 +1,21 @@
+/*
+Author: Kamya Hari
+Class: ECE6122 A
+Last Date Modified: 10/18/2026
+Description:
+Header file for the host (CPU) Game of Life backend
+*/
+// cpu_kernels.h
+#ifndef CPU_KERNELS_H
+#define CPU_KERNELS_H
+
+#include "life_simulation.h"
+#include <memory>
+
+// Same rule and non-wrapping, bounds-checked neighborhood as updateGameOfLifeKernel, split across numThreads host threads
+void updateGameOfLifeCPU(const bool* currentGrid, bool* nextGrid, int width, int height, int numThreads);
+
+// LifeSimulation backend running updateGameOfLifeCPU on plain host memory
+std::unique_ptr<LifeBackend> createHostBackend(int numThreads);
+
+#endif
@@ -1,19 +1,18 @@
 /*
 Author: Kamya Hari
 Class: ECE6122 A
-Last Date Modified: 11/08/2024
+Last Date Modified: 10/18/2026
 Description:
-Cuda kernel function to update the grids in Game of Life
+Cuda kernel function to update the grids in Game of Life, and the CUDA backends of LifeSimulation. The grids are
+allocated once per run (device memory for NORMAL and PINNED, managed memory for MANAGED); NORMAL and PINNED keep a
+pageable or pinned host mirror that the front grid is copied into only when the host reads it.
 */
 
 #include "cuda_kernels.cuh"
 #include <cuda_runtime.h>
-#include <iostream>
-
-// Static variables for device memory management
-static bool* d_current = nullptr;
-static bool* d_next = nullptr;
-static size_t last_size = 0;
+#include <cstring>
+#include <stdexcept>
+#include <string>
 
 __global__ void updateGameOfLifeKernel(const bool* currentGrid, bool* nextGrid, int width, int height) {
     int index = blockIdx.x * blockDim.x + threadIdx.x;
@@ -43,169 +42,100 @@ __global__ void updateGameOfLifeKernel(const bool* currentGrid, bool* nextGrid,
                      (!currentGrid[index] && count == 3);
 }
 
-void cleanupGameOfLife() {
-    if (d_current != nullptr) {
-        cudaFree(d_current);
-        cudaFree(d_next);
-        d_current = nullptr;
-        d_next = nullptr;
-        last_size = 0;
+namespace {
+    const char* memoryTypeName(MemoryType memoryType) {
+        switch (memoryType) {
+            case NORMAL: return "NORMAL";
+            case PINNED: return "PINNED";
+            case MANAGED: return "MANAGED";
+            default: return "CPU";
+        }
     }
-}
 
-void updateGameOfLife(bool* currentGrid, bool* nextGrid, int width, int height, int numThreads, MemoryType memoryType) {
-    cudaError_t err;
-    size_t size = width * height * sizeof(bool);
-    
-    // Calculate grid dimensions
-    int threadsPerBlock = numThreads;
-    int blocksPerGrid = (width * height + threadsPerBlock - 1) / threadsPerBlock;
-    
-    switch(memoryType) {
-        case NORMAL: {
-            // Regular CUDA memory allocation and transfers
-            err = cudaMalloc(&d_current, size);
-            if (err != cudaSuccess) {
-                std::cerr << "NORMAL: Failed to allocate d_current: " << cudaGetErrorString(err) << std::endl;
-                return;
-            }
-            
-            err = cudaMalloc(&d_next, size);
-            if (err != cudaSuccess) {
-                std::cerr << "NORMAL: Failed to allocate d_next: " << cudaGetErrorString(err) << std::endl;
-                cudaFree(d_current);
-                return;
-            }
-            
-            err = cudaMemcpy(d_current, currentGrid, size, cudaMemcpyHostToDevice);
-            if (err != cudaSuccess) {
-                std::cerr << "NORMAL: Failed to copy to device: " << cudaGetErrorString(err) << std::endl;
-                cudaFree(d_current);
-                cudaFree(d_next);
-                return;
+    class CudaLifeBackend : public LifeBackend {
+    public:
+        CudaLifeBackend(MemoryType memoryType, int threadsPerBlock)
+            : memoryType(memoryType), threadsPerBlock(threadsPerBlock) {}
+
+        bool* allocateGrid(size_t bytes) override {
+            bool* grid = nullptr;
+            if (memoryType == MANAGED) {
+                check(cudaMallocManaged(&grid, bytes), "Failed to allocate managed grid");
             }
-            
-            updateGameOfLifeKernel<<<blocksPerGrid, threadsPerBlock>>>(d_current, d_next, width, height);
-            cudaDeviceSynchronize();
-            
-            err = cudaMemcpy(nextGrid, d_next, size, cudaMemcpyDeviceToHost);
-            if (err != cudaSuccess) {
-                std::cerr << "NORMAL: Failed to copy from device: " << cudaGetErrorString(err) << std::endl;
+            else {
+                check(cudaMalloc(&grid, bytes), "Failed to allocate device grid");
             }
-            
-            cudaFree(d_current);
-            cudaFree(d_next);
-            break;
+            return grid;
         }
-        
-        case PINNED: {
-            // Create pinned memory buffers for efficient transfers
-            bool* h_pinned_current;
-            bool* h_pinned_next;
-            
-            err = cudaHostAlloc(&h_pinned_current, size, cudaHostAllocDefault);
-            if (err != cudaSuccess) {
-                std::cerr << "PINNED: Failed to allocate pinned current buffer: " << cudaGetErrorString(err) << std::endl;
-                return;
-            }
-            
-            err = cudaHostAlloc(&h_pinned_next, size, cudaHostAllocDefault);
-            if (err != cudaSuccess) {
-                std::cerr << "PINNED: Failed to allocate pinned next buffer: " << cudaGetErrorString(err) << std::endl;
-                cudaFreeHost(h_pinned_current);
-                return;
+
+        void freeGrid(bool* grid) override {
+            cudaFree(grid);
+        }
+
+        bool* allocateHostMirror(size_t bytes) override {
+            bool* mirror = nullptr;
+            switch (memoryType) {
+                case NORMAL:
+                    mirror = new bool[bytes];
+                    break;
+                case PINNED:
+                    check(cudaHostAlloc(&mirror, bytes, cudaHostAllocDefault), "Failed to allocate pinned host buffer");
+                    break;
+                default:
+                    break;  // managed grids are read by the host directly
             }
-            
-            // Copy input data to pinned memory
-            memcpy(h_pinned_current, currentGrid, size);
-            
-            // Allocate device memory
-            err = cudaMalloc(&d_current, size);
-            if (err != cudaSuccess) {
-                std::cerr << "PINNED: Failed to allocate d_current: " << cudaGetErrorString(err) << std::endl;
-                cudaFreeHost(h_pinned_current);
-                cudaFreeHost(h_pinned_next);
-                return;
+            return mirror;
+        }
+
+        void freeHostMirror(bool* mirror) override {
+            if (memoryType == PINNED) {
+                cudaFreeHost(mirror);
             }
-            
-            err = cudaMalloc(&d_next, size);
-            if (err != cudaSuccess) {
-                std::cerr << "PINNED: Failed to allocate d_next: " << cudaGetErrorString(err) << std::endl;
-                cudaFree(d_current);
-                cudaFreeHost(h_pinned_current);
-                cudaFreeHost(h_pinned_next);
-                return;
+            else {
+                delete[] mirror;
             }
-            
-            // Transfer from pinned memory to device
-            err = cudaMemcpy(d_current, h_pinned_current, size, cudaMemcpyHostToDevice);
-            if (err != cudaSuccess) {
-                std::cerr << "PINNED: Failed to copy to device: " << cudaGetErrorString(err) << std::endl;
-                cudaFree(d_current);
-                cudaFree(d_next);
-                cudaFreeHost(h_pinned_current);
-                cudaFreeHost(h_pinned_next);
-                return;
+        }
+
+        void upload(bool* grid, const bool* host, size_t bytes) override {
+            if (memoryType == MANAGED) {
+                std::memcpy(grid, host, bytes);
             }
-            
-            updateGameOfLifeKernel<<<blocksPerGrid, threadsPerBlock>>>(d_current, d_next, width, height);
-            cudaDeviceSynchronize();
-            
-            // Transfer result to pinned memory
-            err = cudaMemcpy(h_pinned_next, d_next, size, cudaMemcpyDeviceToHost);
-            if (err != cudaSuccess) {
-                std::cerr << "PINNED: Failed to copy from device: " << cudaGetErrorString(err) << std::endl;
+            else {
+                check(cudaMemcpy(grid, host, bytes, cudaMemcpyHostToDevice), "Failed to copy to device");
             }
-            
-            // Copy result from pinned memory to output buffer
-            memcpy(nextGrid, h_pinned_next, size);
-            
-            // Cleanup
-            cudaFree(d_current);
-            cudaFree(d_next);
-            cudaFreeHost(h_pinned_current);
-            cudaFreeHost(h_pinned_next);
-            break;
         }
-        
-        case MANAGED: {
-            // Use CUDA managed memory
-            err = cudaMallocManaged(&d_current, size);
-            if (err != cudaSuccess) {
-                std::cerr << "MANAGED: Failed to allocate managed memory for d_current: " << cudaGetErrorString(err) << std::endl;
-                return;
+
+        void download(bool* host, const bool* grid, size_t bytes) override {
+            if (memoryType == MANAGED) {
+                std::memcpy(host, grid, bytes);
             }
-            
-            err = cudaMallocManaged(&d_next, size);
-            if (err != cudaSuccess) {
-                std::cerr << "MANAGED: Failed to allocate managed memory for d_next: " << cudaGetErrorString(err) << std::endl;
-                cudaFree(d_current);
-                return;
+            else {
+                check(cudaMemcpy(host, grid, bytes, cudaMemcpyDeviceToHost), "Failed to copy from device");
             }
-            
-            // Copy initial state
-            memcpy(d_current, currentGrid, size);
-            
-            updateGameOfLifeKernel<<<blocksPerGrid, threadsPerBlock>>>(d_current, d_next, width, height);
-            err = cudaDeviceSynchronize();
+        }
+
+        void update(const bool* current, bool* next, int width, int height) override {
+            int blocksPerGrid = (width * height + threadsPerBlock - 1) / threadsPerBlock;
+            updateGameOfLifeKernel<<<blocksPerGrid, threadsPerBlock>>>(current, next, width, height);
+            check(cudaGetLastError(), "Kernel launch failed");
+        }
+
+        void synchronize() override {
+            check(cudaDeviceSynchronize(), "Kernel execution failed");
+        }
+
+    private:
+        void check(cudaError_t err, const char* what) const {
             if (err != cudaSuccess) {
-                std::cerr << "MANAGED: Kernel execution failed: " << cudaGetErrorString(err) << std::endl;
+                throw std::runtime_error(std::string(memoryTypeName(memoryType)) + ": " + what + ": " + cudaGetErrorString(err));
             }
-            
-            // Copy result back
-            memcpy(nextGrid, d_next, size);
-            
-            // Cleanup
-            cudaFree(d_current);
-            cudaFree(d_next);
-            break;
         }
-    }
-    
-    // Check for kernel errors
-    err = cudaGetLastError();
-    if (err != cudaSuccess) {
-        std::cerr << "Kernel execution failed: " << cudaGetErrorString(err) << std::endl;
-        return;
-    }
-}
\ No newline at end of file
+
+        MemoryType memoryType;
+        int threadsPerBlock;
+    };
+}
+
+std::unique_ptr<LifeBackend> createCudaBackend(MemoryType memoryType, int threadsPerBlock) {
+    return std::unique_ptr<LifeBackend>(new CudaLifeBackend(memoryType, threadsPerBlock));
+}
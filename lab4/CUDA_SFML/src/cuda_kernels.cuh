@@ -1,17 +1,19 @@
 /*
 Author: Kamya Hari
 Class: ECE6122 A
-Last Date Modified: 11/08/2024
+Last Date Modified: 10/18/2026
 Description:
-Header file for the CUDA kernel function
+Header file for the CUDA backends of LifeSimulation
 */
 // cuda_kernels.cuh
 #ifndef CUDA_KERNELS_H
 #define CUDA_KERNELS_H
 
 #include "common.h"
+#include "life_simulation.h"
+#include <memory>
 
-void updateGameOfLife(bool* currentGrid, bool* nextGrid, int width, int height, int numThreads, MemoryType memoryType);
-void cleanupGameOfLife();
+// LifeSimulation backend for the NORMAL, PINNED and MANAGED memory types
+std::unique_ptr<LifeBackend> createCudaBackend(MemoryType memoryType, int threadsPerBlock);
 
 #endif
@@ -0,0 +1,84 @@
+/*
+Author: Kamya Hari
+Class: ECE6122 A
+Last Date Modified: 10/18/2026
+Description:
+Buffer management of the persistent Game of Life simulation context
+*/
+
+#include "life_simulation.h"
+#include "cpu_kernels.h"
+#include "phase_timer.h"
+#include <stdexcept>
+#include <utility>
+#ifdef GOL_WITH_CUDA
+#include "cuda_kernels.cuh"
+#endif
+
+LifeSimulation::LifeSimulation(int width, int height, MemoryType memoryType, int threads, bool timed)
+    : width(width), height(height), bytes(static_cast<size_t>(width) * height * sizeof(bool)),
+      front(nullptr), back(nullptr), hostMirror(nullptr), mirrorValid(false), generationCount(0), timed(timed) {
+    if (memoryType == CPU) {
+        backend = createHostBackend(threads);
+    }
+    else {
+#ifdef GOL_WITH_CUDA
+        backend = createCudaBackend(memoryType, threads);
+#else
+        throw std::invalid_argument("CUDA memory types need a GOL_WITH_CUDA build.");
+#endif
+    }
+
+    GOL_TIME_PHASE_IF(timed, PHASE_ALLOC);
+    try {
+        front = backend->allocateGrid(bytes);
+        back = backend->allocateGrid(bytes);
+        hostMirror = backend->allocateHostMirror(bytes);
+    }
+    catch (...) {
+        release();
+        throw;
+    }
+}
+
+LifeSimulation::~LifeSimulation() {
+    GOL_TIME_PHASE_IF(timed, PHASE_FREE);
+    release();
+}
+
+void LifeSimulation::release() {
+    if (hostMirror) backend->freeHostMirror(hostMirror);
+    if (back) backend->freeGrid(back);
+    if (front) backend->freeGrid(front);
+    hostMirror = back = front = nullptr;
+}
+
+void LifeSimulation::setGrid(const bool* hostGrid) {
+    GOL_TIME_PHASE_IF(timed, PHASE_H2D);
+    backend->synchronize();  // no update may still be using the front grid
+    backend->upload(front, hostGrid, bytes);
+    mirrorValid = false;
+}
+
+void LifeSimulation::step(int generations) {
+    GOL_TIME_PHASE_IF(timed, PHASE_KERNEL);
+    for (int i = 0; i < generations; ++i) {
+        backend->update(front, back, width, height);
+        std::swap(front, back);
+    }
+    backend->synchronize();
+    generationCount += generations;
+    mirrorValid = false;
+}
+
+const bool* LifeSimulation::grid() {
+    if (!hostMirror) {
+        return front;  // host backend and managed memory: readable after step() synchronized
+    }
+    if (!mirrorValid) {
+        GOL_TIME_PHASE_IF(timed, PHASE_D2H);
+        backend->download(hostMirror, front, bytes);
+        mirrorValid = true;
+    }
+    return hostMirror;
+}
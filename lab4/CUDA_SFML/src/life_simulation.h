@@ -0,0 +1,64 @@
+/*
+Author: Kamya Hari
+Class: ECE6122 A
+Last Date Modified: 10/18/2026
+Description:
+Persistent Game of Life simulation context. LifeSimulation allocates its front and back grids once for the whole run,
+advances them by swapping pointers after every generation and only copies the front grid back to the host when the
+caller asks for it. The memory-type specific work (allocation, transfers, kernel launch) is delegated to a
+LifeBackend, so the host backend exercises exactly the same buffer management as the CUDA ones.
+This header is also included from cuda_kernels.cu, so it must stay C++11.
+*/
+// life_simulation.h
+#ifndef LIFE_SIMULATION_H
+#define LIFE_SIMULATION_H
+
+#include "common.h"
+#include <cstddef>
+#include <memory>
+
+// Primitive operations a backend provides to LifeSimulation; errors are reported by throwing std::runtime_error
+class LifeBackend {
+public:
+    virtual ~LifeBackend() {}
+    virtual bool* allocateGrid(size_t bytes) = 0;        // buffer the update reads from / writes to
+    virtual void freeGrid(bool* grid) = 0;
+    virtual bool* allocateHostMirror(size_t bytes) = 0;  // host copy of the front grid, nullptr if grids are host-readable
+    virtual void freeHostMirror(bool* mirror) = 0;
+    virtual void upload(bool* grid, const bool* host, size_t bytes) = 0;
+    virtual void download(bool* host, const bool* grid, size_t bytes) = 0;
+    virtual void update(const bool* current, bool* next, int width, int height) = 0;  // may run asynchronously
+    virtual void synchronize() = 0;                      // wait for all queued updates
+};
+
+class LifeSimulation {
+public:
+    // threads is the number of threads per block for the CUDA memory types and the number of host threads for CPU;
+    // timed = false keeps this instance from reporting its phases to the installed PhaseTimer
+    LifeSimulation(int width, int height, MemoryType memoryType, int threads, bool timed = true);
+    ~LifeSimulation();
+
+    void setGrid(const bool* hostGrid);  // replace the current generation
+    void step(int generations = 1);      // advance without any host round trip
+    const bool* grid();                  // current generation, readable by the host
+    long long generation() const { return generationCount; }
+
+    LifeSimulation(const LifeSimulation&) = delete;  // owns raw buffers, not copyable
+    LifeSimulation& operator=(const LifeSimulation&) = delete;
+
+private:
+    void release();
+
+    std::unique_ptr<LifeBackend> backend;
+    int width;
+    int height;
+    size_t bytes;
+    bool* front;          // current generation
+    bool* back;           // next generation is written here, then the two are swapped
+    bool* hostMirror;     // nullptr when front is host-readable
+    bool mirrorValid;     // hostMirror holds the current front grid
+    long long generationCount;
+    bool timed;           // report phases to the installed PhaseTimer
+};
+
+#endif
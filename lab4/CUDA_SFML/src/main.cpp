@@ -5,6 +5,13 @@ Last Date Modified: 11/08/2024
 Description:
 This is the main function that displays Lab4 - using CUDA to run Game of Life. This function parses through the input arguments and generates the SFML graphics 
 required to show the Game of Life in action. Kernel calls are established and the time for updating the kernel using each memory type is then printed out.
+-t CPU runs the host backend instead, which is the only backend when built with GOL_WITH_CUDA=OFF. With -v, every GPU
+generation is also computed on the host from the same input and the two results are compared cell by cell.
+The grids live in a LifeSimulation context for the whole run; -s N advances N generations per rendered frame
+without copying back to the host in between.
+Every phase of a generation (allocation, transfers, kernel, copies, rendering) is reported to a RollingPhaseStats
+timer that prints per-phase statistics every 100 rendered frames and, with -p <file>, writes one CSV row per frame
+(one generation unless -s is given).
 */
 
 #include <SFML/Graphics.hpp>
@@ -16,9 +23,13 @@ required to show the Game of Life in action. Kernel calls are established and th
 #include <chrono>
 #include <deque>
 #include <iomanip>
-#include <cuda_runtime.h>
-#include "cuda_kernels.cuh"
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <memory>
 #include"common.h"
+#include "life_simulation.h"
+#include "phase_timer.h"
 
 int numThreads = 32;         // Threads per block (default 32, multiple of 32)
 int cellSize = 5;            // Cell size (default 5)
@@ -26,6 +37,10 @@ int windowWidth = 800;       // Window width (default 800)
 int windowHeight = 600;      // Window height (default 600)
 
 MemoryType memoryType = NORMAL;  // Memory type (default NORMAL)
+int hostThreads = 1;         // Threads used by the host backend
+bool verifyOnHost = false;   // Compare every GPU generation against the host backend
+std::string phaseCsvPath;    // Per-generation phase timings (empty: no CSV)
+int generationsPerFrame = 1; // Generations advanced on the device between two rendered frames
 
 // For tracking generation times (in microseconds)
 std::deque<long long> generationTimes;  
@@ -35,11 +50,12 @@ MemoryType parseMemoryType(const std::string& type) {
     if (type == "NORMAL") return NORMAL;
     else if (type == "PINNED") return PINNED;
     else if (type == "MANAGED") return MANAGED;
-    else throw std::invalid_argument("Invalid memory type. Use NORMAL, PINNED, or MANAGED.");
+    else if (type == "CPU") return CPU;
+    else throw std::invalid_argument("Invalid memory type. Use NORMAL, PINNED, MANAGED, or CPU.");
 }
 
 // Array with enum names
-const std::string memStrings[] = { "Normal", "Pinned", "Managed" };
+const std::string memStrings[] = { "Normal", "Pinned", "Managed", "CPU" };
 std::string memToString(MemoryType mem) {
     return memStrings[mem];
 }
@@ -74,10 +90,30 @@ void parseArguments(int argc, char* argv[]) {
         else if (std::strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
             memoryType = parseMemoryType(argv[++i]);
         }
+        else if (std::strcmp(argv[i], "-v") == 0) {
+            verifyOnHost = true;
+        }
+        else if (std::strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+#ifdef GOL_NO_PHASE_TIMING
+            throw std::invalid_argument("This build has no phase timing (GOL_PHASE_TIMING=OFF); -p is not available.");
+#endif
+            phaseCsvPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            generationsPerFrame = std::atoi(argv[++i]);
+            if (generationsPerFrame < 1) {
+                throw std::invalid_argument("Generations per frame (-s) must be >= 1.");
+            }
+        }
         else {
             throw std::invalid_argument("Unknown argument or missing value.");
         }
     }
+#ifndef GOL_WITH_CUDA
+    if (memoryType != CPU) {
+        throw std::invalid_argument("This build has no CUDA support (GOL_WITH_CUDA=OFF); use -t CPU.");
+    }
+#endif
 }
 
 
@@ -93,12 +129,24 @@ void printAverageGenerationTime() {
     //long long average = sum / generationTimes.size();
 
     // Output the average time (in microseconds)
-    std::cout << "100 generations took " << sum << " microsecs with " << numThreads << " threads per block using " <<memToString(memoryType) << " memory allocation." << std::endl;
+    size_t generations = generationTimes.size() * generationsPerFrame;
+    if (memoryType == CPU) {
+        std::cout << generations << " generations took " << sum << " microsecs with " << hostThreads << " host threads using the CPU backend." << std::endl;
+        return;
+    }
+    std::cout << generations << " generations took " << sum << " microsecs with " << numThreads << " threads per block using " <<memToString(memoryType) << " memory allocation." << std::endl;
 }
 
 int main(int argc, char* argv[]) {
     try {
         parseArguments(argc, argv);
+        hostThreads = std::max(1u, std::thread::hardware_concurrency());
+
+        // Collect per-phase timings for the last 100 frames
+#ifndef GOL_NO_PHASE_TIMING
+        RollingPhaseStats phaseStats(100, phaseCsvPath, generationsPerFrame);
+        setPhaseTimer(&phaseStats);
+#endif
 
         // Set up SFML window
         sf::RenderWindow window(sf::VideoMode(windowWidth, windowHeight), "Game of Life");
@@ -107,118 +155,112 @@ int main(int argc, char* argv[]) {
         int gridWidth = windowWidth / cellSize;
         int gridHeight = windowHeight / cellSize;
 
-        // Allocate memory based on memory type
-        bool* grid_current;
-        bool* grid_next;
-
-        switch (memoryType) {
-        case NORMAL:
-            grid_current = new bool[gridWidth * gridHeight];
-            grid_next = new bool[gridWidth * gridHeight];
-            break;
-
-        case PINNED:
-            cudaMallocHost(&grid_current, gridWidth * gridHeight * sizeof(bool));
-            cudaMallocHost(&grid_next, gridWidth * gridHeight * sizeof(bool));
-            break;
-
-        case MANAGED:
-            cudaMallocManaged(&grid_current, gridWidth * gridHeight * sizeof(bool));
-            cudaMallocManaged(&grid_next, gridWidth * gridHeight * sizeof(bool));
-            break;
-        }
-
         // Seed the grid with random values
+        std::vector<char> seedGrid(gridWidth * gridHeight);
         std::srand(static_cast<unsigned>(std::time(nullptr)));
         for (int i = 0; i < gridWidth * gridHeight; ++i) {
-            grid_current[i] = std::rand() % 2;
-        }
-
-        // Allocate and initialize device memory for the grid
-        bool* d_grid_current;
-        bool* d_grid_next;
-
-        // Only allocate separate device memory if not using managed memory
-        if (memoryType != MANAGED) {
-            cudaMalloc(&d_grid_current, gridWidth * gridHeight * sizeof(bool));
-            cudaMalloc(&d_grid_next, gridWidth * gridHeight * sizeof(bool));
-
-            // Copy the initial state to device
-            cudaMemcpy(d_grid_current, grid_current,
-                gridWidth * gridHeight * sizeof(bool),
-                cudaMemcpyHostToDevice);
-        }
-        else {
-            // For managed memory, use the same pointers
-            d_grid_current = grid_current;
-            d_grid_next = grid_next;
+            seedGrid[i] = std::rand() % 2;
         }
 
-        // Main loop
-        int generationCount = 0; // To count the number of generations
-        while (window.isOpen()) {
-            sf::Event event;
-            while (window.pollEvent(event)) {
-                if (event.type == sf::Event::Closed) {
-                    window.close();
-                }
+        // The simulations are destroyed at the end of this scope, while the timer is still installed, so freeing their
+        // buffers is reported as a last row of its own
+        {
+            // The simulation owns its front/back buffers for the whole run
+            LifeSimulation simulation(gridWidth, gridHeight, memoryType, memoryType == CPU ? hostThreads : numThreads);
+            simulation.setGrid(reinterpret_cast<const bool*>(seedGrid.data()));
+
+            // Host reference simulation for -v
+            std::unique_ptr<LifeSimulation> reference;
+            if (verifyOnHost && memoryType != CPU) {
+                reference.reset(new LifeSimulation(gridWidth, gridHeight, CPU, hostThreads, false));  // untimed: its work is "verify", not the device's phases
+                reference->setGrid(reinterpret_cast<const bool*>(seedGrid.data()));
             }
+            long long verifyMismatches = 0;
+
+            // Main loop
+            int generationCount = 0; // To count the number of generations
+            while (window.isOpen()) {
+                sf::Event event;
+                while (window.pollEvent(event)) {
+                    if (event.type == sf::Event::Closed) {
+                        window.close();
+                    }
+                }
 
-            // Measure the time for kernel execution (excluding rendering)
-            auto startKernel = std::chrono::high_resolution_clock::now();
-
-            // Launch the CUDA kernel to update the grid
-
-            updateGameOfLife(grid_current, grid_next, gridWidth, gridHeight, numThreads, memoryType);
-
-            auto endKernel = std::chrono::high_resolution_clock::now();
-            auto kernelDuration = std::chrono::duration_cast<std::chrono::microseconds>(endKernel - startKernel).count();
-
-            // Measure the time for copying the data from the device to the host
-            auto startMemcpy = std::chrono::high_resolution_clock::now();
+                // Measure the time for advancing the simulation and reading it back (excluding rendering)
+                auto startKernel = std::chrono::high_resolution_clock::now();
 
-            // Copy updated state back to current grid
-            std::memcpy(grid_current, grid_next, gridWidth * gridHeight * sizeof(bool));
+                simulation.step(generationsPerFrame);
+                const bool* grid_current = simulation.grid();
 
-            auto endMemcpy = std::chrono::high_resolution_clock::now();
-            auto memcpyDuration = std::chrono::duration_cast<std::chrono::microseconds>(endMemcpy - startMemcpy).count();
+                auto endKernel = std::chrono::high_resolution_clock::now();
+                long long totalGenerationTime = std::chrono::duration_cast<std::chrono::microseconds>(endKernel - startKernel).count();
 
-            // Total time for the generation (kernel + memory copy)
-            long long totalGenerationTime = kernelDuration + memcpyDuration;
+                // Advance the host reference by the same generations and compare it with the device result bit for bit
+                if (reference) {
+                    GOL_TIME_PHASE(PHASE_VERIFY);
+                    reference->step(generationsPerFrame);
+                    const bool* expected = reference->grid();
+                    int mismatches = 0;
+                    for (int i = 0; i < gridWidth * gridHeight; ++i) {
+                        mismatches += (expected[i] != grid_current[i]);
+                    }
+                    if (mismatches != 0) {
+                        std::cerr << "Generation " << simulation.generation() << ": host and device differ in " << mismatches << " cells" << std::endl;
+                        reference->setGrid(grid_current);  // resynchronize so later generations are compared from the same input
+                    }
+                    verifyMismatches += mismatches;
+                }
 
-            // Add the generation time to the list
-            generationTimes.push_back(totalGenerationTime);
+                // Add the generation time to the list
+                generationTimes.push_back(totalGenerationTime);
 
-            // Limit the number of times we store to 100 generations
-            if (generationTimes.size() > 100) {
-                generationTimes.pop_front();
-            }
+                // Limit the number of times we store to 100 generations
+                if (generationTimes.size() > 100) {
+                    generationTimes.pop_front();
+                }
 
-            // Clear the window
-            window.clear();
-
-            // Draw the grid using SFML
-            for (int x = 0; x < gridWidth; ++x) {
-                for (int y = 0; y < gridHeight; ++y) {
-                    if (grid_current[y * gridWidth + x]) {
-                        sf::RectangleShape cell(sf::Vector2f(cellSize, cellSize));
-                        cell.setPosition(x * cellSize, y * cellSize);
-                        cell.setFillColor(sf::Color::White);
-                        window.draw(cell);
+                {
+                    GOL_TIME_PHASE(PHASE_RENDER);
+
+                    // Clear the window
+                    window.clear();
+
+                    // Draw the grid using SFML
+                    for (int x = 0; x < gridWidth; ++x) {
+                        for (int y = 0; y < gridHeight; ++y) {
+                            if (grid_current[y * gridWidth + x]) {
+                                sf::RectangleShape cell(sf::Vector2f(cellSize, cellSize));
+                                cell.setPosition(x * cellSize, y * cellSize);
+                                cell.setFillColor(sf::Color::White);
+                                window.draw(cell);
+                            }
+                        }
                     }
                 }
-            }
 
-            // Display the updated window
-            window.display();
-
-            // Print the generation time every 100 generations
-            if (++generationCount % 100 == 0) {
-                printAverageGenerationTime();
+                // Display the updated window (includes waiting for the frame rate limit)
+                {
+                    GOL_TIME_PHASE(PHASE_PRESENT);
+                    window.display();
+                }
+                GOL_END_GENERATION();
+
+                // Print the generation time every 100 generations
+                if (++generationCount % 100 == 0) {
+                    printAverageGenerationTime();
+#ifndef GOL_NO_PHASE_TIMING
+                    phaseStats.printSummary(std::cout);
+#endif
+                    if (reference) {
+                        std::cout << "Host/device verification: " << verifyMismatches << " mismatching cells so far." << std::endl;
+                    }
+                }
             }
         }
+        GOL_END_GENERATION();
 
-        cleanupGameOfLife();
+        setPhaseTimer(nullptr);
 
 
     }
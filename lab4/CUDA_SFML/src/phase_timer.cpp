@@ -0,0 +1,97 @@
+/*
+Author: Kamya Hari
+Class: ECE6122 A
+Last Date Modified: 10/18/2026
+Description:
+Phase timer registry and the rolling statistics / CSV implementation
+*/
+
+#include "phase_timer.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+static PhaseTimer* installedTimer = nullptr;
+
+static const char* phaseNames[PHASE_COUNT] = { "alloc", "h2d", "kernel", "d2h", "free", "verify", "render", "present" };
+
+const char* phaseName(Phase phase) {
+    return phaseNames[phase];
+}
+
+void setPhaseTimer(PhaseTimer* timer) {
+    installedTimer = timer;
+}
+
+PhaseTimer* currentPhaseTimer() {
+    return installedTimer;
+}
+
+RollingPhaseStats::RollingPhaseStats(size_t window, const std::string& csvPath, int generationsPerFrame)
+    : window(window), generationsPerFrame(generationsPerFrame), generation(0) {
+    std::fill(current, current + PHASE_COUNT, 0.0);
+    if (!csvPath.empty()) {
+        csv.open(csvPath);
+        csv << "generation";
+        for (int p = 0; p < PHASE_COUNT; ++p) {
+            csv << "," << phaseNames[p] << "_us";
+        }
+        csv << ",total_us\n";
+    }
+}
+
+void RollingPhaseStats::record(Phase phase, double microseconds) {
+    current[phase] += microseconds;
+}
+
+void RollingPhaseStats::endGeneration() {
+    double total = 0.0;
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        history[p].push_back(current[p]);
+        if (history[p].size() > window) {
+            history[p].pop_front();
+        }
+        total += current[p];
+    }
+
+    if (csv.is_open()) {
+        csv << generation;
+        for (int p = 0; p < PHASE_COUNT; ++p) {
+            csv << "," << current[p];
+        }
+        csv << "," << total << "\n";
+    }
+
+    std::fill(current, current + PHASE_COUNT, 0.0);
+    generation += generationsPerFrame;
+}
+
+void RollingPhaseStats::printSummary(std::ostream& out) const {
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    if (generationsPerFrame == 1) {
+        out << "Phase times over the last " << history[0].size() << " generations (microsecs: mean / min / max / stddev)" << std::endl;
+    }
+    else {
+        out << "Phase times over the last " << history[0].size() << " frames of " << generationsPerFrame
+            << " generations (microsecs per frame: mean / min / max / stddev)" << std::endl;
+    }
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        const std::deque<double>& samples = history[p];
+        if (samples.empty() || *std::max_element(samples.begin(), samples.end()) == 0.0) {
+            continue;  // phase not used by this backend
+        }
+        double sum = 0.0, sumSquares = 0.0;
+        for (double s : samples) {
+            sum += s;
+            sumSquares += s * s;
+        }
+        double mean = sum / samples.size();
+        double variance = std::max(0.0, sumSquares / samples.size() - mean * mean);
+        out << "  " << std::left << std::setw(10) << phaseNames[p] << std::right << std::fixed << std::setprecision(1)
+            << std::setw(10) << mean << std::setw(10) << *std::min_element(samples.begin(), samples.end())
+            << std::setw(10) << *std::max_element(samples.begin(), samples.end()) << std::setw(10) << std::sqrt(variance) << std::endl;
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
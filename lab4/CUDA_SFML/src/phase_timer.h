@@ -0,0 +1,88 @@
+/*
+Author: Kamya Hari
+Class: ECE6122 A
+Last Date Modified: 10/18/2026
+Description:
+Per-phase timing for the Game of Life generation pipeline. Backends and the main loop wrap each phase in
+GOL_TIME_PHASE(phase), which reports the elapsed time to whatever PhaseTimer is installed with setPhaseTimer.
+GOL_TIME_PHASE_IF(enabled, phase) only reports when 'enabled' is true, so one instance (e.g. a reference simulation
+that is not being measured) can stay silent while another reports.
+RollingPhaseStats keeps rolling statistics over the last rendered frames and can write one CSV row per frame; a frame
+covers 'generationsPerFrame' generations (-s), so the CSV labels each row with the first generation it covers.
+Configuring with GOL_PHASE_TIMING=OFF defines GOL_NO_PHASE_TIMING and compiles every GOL_TIME_PHASE away.
+This header is also included from cuda_kernels.cu, so it must stay C++11.
+*/
+// phase_timer.h
+#ifndef PHASE_TIMER_H
+#define PHASE_TIMER_H
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <fstream>
+#include <ostream>
+#include <string>
+
+// Phases of one generation, in pipeline order
+enum Phase { PHASE_ALLOC, PHASE_H2D, PHASE_KERNEL, PHASE_D2H, PHASE_FREE, PHASE_VERIFY, PHASE_RENDER, PHASE_PRESENT, PHASE_COUNT };
+
+const char* phaseName(Phase phase);
+
+// Interface the pipeline reports into
+class PhaseTimer {
+public:
+    virtual ~PhaseTimer() {}
+    virtual void record(Phase phase, double microseconds) = 0;  // may be called several times per phase and generation
+    virtual void endGeneration() = 0;
+};
+
+void setPhaseTimer(PhaseTimer* timer);  // nullptr disables reporting
+PhaseTimer* currentPhaseTimer();
+
+// Times the enclosing scope and reports it to the installed timer, unless disabled
+class ScopedPhase {
+public:
+    explicit ScopedPhase(Phase phase, bool enabled = true) : phase(phase), enabled(enabled), start(std::chrono::steady_clock::now()) {}
+    ~ScopedPhase() {
+        PhaseTimer* timer = enabled ? currentPhaseTimer() : nullptr;
+        if (timer) {
+            timer->record(phase, std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        }
+    }
+private:
+    Phase phase;
+    bool enabled;
+    std::chrono::steady_clock::time_point start;
+};
+
+#define GOL_PHASE_CONCAT_INNER(a, b) a##b
+#define GOL_PHASE_CONCAT(a, b) GOL_PHASE_CONCAT_INNER(a, b)
+#ifdef GOL_NO_PHASE_TIMING
+#define GOL_TIME_PHASE(phase) ((void)0)
+#define GOL_TIME_PHASE_IF(enabled, phase) ((void)0)
+#define GOL_END_GENERATION() ((void)0)
+#else
+#define GOL_TIME_PHASE(phase) ScopedPhase GOL_PHASE_CONCAT(scopedPhase, __LINE__)(phase)
+#define GOL_TIME_PHASE_IF(enabled, phase) ScopedPhase GOL_PHASE_CONCAT(scopedPhase, __LINE__)(phase, enabled)
+#define GOL_END_GENERATION() do { if (PhaseTimer* phaseTimer = currentPhaseTimer()) phaseTimer->endGeneration(); } while (0)
+#endif
+
+// Rolling per-phase statistics over the last 'window' frames of 'generationsPerFrame' generations each, plus an optional per-frame CSV
+class RollingPhaseStats : public PhaseTimer {
+public:
+    RollingPhaseStats(size_t window, const std::string& csvPath, int generationsPerFrame = 1);
+
+    void record(Phase phase, double microseconds) override;
+    void endGeneration() override;
+    void printSummary(std::ostream& out) const;  // mean, min, max and standard deviation per phase
+
+private:
+    size_t window;
+    int generationsPerFrame;
+    long long generation;  // first generation of the current frame
+    double current[PHASE_COUNT];
+    std::deque<double> history[PHASE_COUNT];
+    std::ofstream csv;
+};
+
+#endif
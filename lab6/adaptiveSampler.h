@@ -0,0 +1,143 @@
+/*
+Author: Kamya Hari
+Course: ECE 6122 A
+Last Date Modified: 10/18/2026
+
+Description:
+Adaptive Monte Carlo for -E <tolerance>. Every rank draws its samples in batches and keeps a running count, mean and
+sum of squared deviations (Welford). After each batch the ranks start a non-blocking allreduce that merges those
+statistics with Chan's parallel formula, and keep sampling the next batch while it is in flight. Once it completes,
+every rank sees the same global statistics and stops as soon as the standard error of the integral is below the
+tolerance, so no rank draws more than one batch past the point where the answer was already good enough.
+*/
+
+#ifndef ADAPTIVE_SAMPLER_H
+#define ADAPTIVE_SAMPLER_H
+
+#include <mpi.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include "philoxRng.h"
+
+// Running statistics of the integrand values; count is a double so the struct is three MPI_DOUBLEs
+struct RunningStats {
+    double count;
+    double mean;
+    double m2;  // sum of squared deviations from the mean
+};
+
+// Welford update with one value
+inline void addSample(RunningStats& stats, double value) {
+    stats.count += 1.0;
+    double delta = value - stats.mean;
+    stats.mean += delta / stats.count;
+    stats.m2 += delta * (value - stats.mean);
+}
+
+// Chan et al. pairwise combination: 'into' becomes the statistics of both sample sets
+inline void mergeStats(RunningStats& into, const RunningStats& other) {
+    if (other.count == 0.0) {
+        return;
+    }
+    double count = into.count + other.count;
+    double delta = other.mean - into.mean;
+    into.mean += delta * (other.count / count);
+    into.m2 += other.m2 + delta * delta * (into.count * other.count / count);
+    into.count = count;
+}
+
+// MPI reduction operator over RunningStats (registered as commutative)
+inline void mergeStatsOp(void* in, void* inout, int* len, MPI_Datatype*) {
+    const RunningStats* src = static_cast<const RunningStats*>(in);
+    RunningStats* dst = static_cast<RunningStats*>(inout);
+    for (int i = 0; i < *len; ++i) {
+        mergeStats(dst[i], src[i]);
+    }
+}
+
+// Standard error of volume * mean
+inline double standardError(const RunningStats& stats, double volume) {
+    if (stats.count < 2.0) {
+        return INFINITY;
+    }
+    return volume * std::sqrt(stats.m2 / (stats.count - 1.0) / stats.count);
+}
+
+struct AdaptiveResult {
+    double estimate;    // integral estimate
+    double stdError;    // standard error of the estimate
+    double samples;     // samples drawn by all ranks
+    int rounds;         // batches drawn per rank
+};
+
+// Samples func on [a, b]^Func::dims until the global standard error is below tolerance or maxSamples (0: no limit)
+// samples have been drawn in total. Rank r reads the same Philox streams as monteCarlo, so the first samples of an
+// adaptive run are the samples of a fixed-N run with the same seed.
+template <typename Func>
+AdaptiveResult adaptiveMonteCarlo(Func func, double a, double b, double tolerance, std::uint64_t batchSamples,
+                                  double maxSamples, std::uint64_t seed, int rank, MPI_Comm comm) {
+    int size;
+    MPI_Comm_size(comm, &size);
+
+    MPI_Datatype statsType;
+    MPI_Type_contiguous(3, MPI_DOUBLE, &statsType);
+    MPI_Type_commit(&statsType);
+    MPI_Op mergeOp;
+    MPI_Op_create(mergeStatsOp, 1, &mergeOp);
+
+    const double volume = std::pow(b - a, Func::dims);
+    RunningStats local = { 0.0, 0.0, 0.0 };
+    BlockedPhiloxStream rng(seed, rank);
+    double x[Func::dims];
+    // Samples of the next batch: a full batch, or what is left of this rank's share of maxSamples. Every rank has drawn
+    // the same count, so all ranks agree on it.
+    const double rankLimit = maxSamples > 0.0 ? std::floor(maxSamples / size) : INFINITY;
+    auto batchSize = [&]() {
+        return static_cast<std::uint64_t>(std::min(static_cast<double>(batchSamples), rankLimit - local.count));
+    };
+    auto drawBatch = [&](std::uint64_t count) {
+        for (std::uint64_t i = 0; i < count; ++i) {
+            for (int d = 0; d < Func::dims; ++d) {
+                x[d] = a + (b - a) * rng.nextUniform();
+            }
+            addSample(local, func(x));
+        }
+    };
+
+    // Round k: reduce the statistics after batch k while batch k + 1 is being drawn, then decide on batch k's totals.
+    // All ranks decide on the same reduced value, so they leave the loop in the same round.
+    RunningStats snapshot, global;
+    MPI_Request request;
+    int rounds = 1;
+    drawBatch(batchSize());
+    while (true) {
+        snapshot = local;
+        MPI_Iallreduce(&snapshot, &global, 1, statsType, mergeOp, comm, &request);
+        std::uint64_t count = batchSize();
+        bool capped = count == 0;
+        if (!capped) {
+            drawBatch(count);
+            ++rounds;
+        }
+        MPI_Wait(&request, MPI_STATUS_IGNORE);
+        if (capped || standardError(global, volume) < tolerance) {
+            break;
+        }
+    }
+
+    // The batch drawn while the last reduction was in flight is kept: one more blocking merge includes it
+    MPI_Allreduce(&local, &global, 1, statsType, mergeOp, comm);
+
+    MPI_Op_free(&mergeOp);
+    MPI_Type_free(&statsType);
+
+    AdaptiveResult result;
+    result.estimate = volume * global.mean;
+    result.stdError = standardError(global, volume);
+    result.samples = global.count;
+    result.rounds = rounds;
+    return result;
+}
+
+#endif // ADAPTIVE_SAMPLER_H
@@ -0,0 +1,195 @@
+/*
+Author: Kamya Hari
+Course: ECE 6122 A
+Last Date Modified: 10/18/2026
+
+Description:
+Checkpoint and restart for long fixed-N runs (--checkpoint <prefix>, --resume). Every rank periodically saves its
+PartialSum (samples done and their compensated sum), its Philox stream position and the parameters of the run.
+The sampling loop only hands a copy of that small record to a background thread, which writes it, so a slow disk
+never stalls the samplers. The records alternate between two slot files, <prefix>.<rank>.a and <prefix>.<rank>.b.
+Each record carries a sequence number and a checksum and is fsync'ed before the next one goes to the other slot.
+A rank that is killed in the middle of a write therefore still has the previous slot intact, and --resume takes the
+valid slot with the highest sequence number. The static shares of the ranks are independent, so every rank continues
+from its own newest checkpoint, and the estimate is bit-identical to that of an uninterrupted run.
+*/
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include "hybridSampler.h"
+
+const std::uint64_t CHECKPOINT_MAGIC = 0x31504b433642414cULL;  // "LAB6CKP1" in little-endian byte order
+const std::uint64_t CHECKPOINT_SEGMENT_SAMPLES = std::uint64_t(1) << 22;  // scalar samples between two progress checks
+const std::uint64_t CHECKPOINT_SEGMENT_CHUNKS = 8;  // hybrid chunks per thread between two progress checks
+
+// One rank's checkpoint, written to disk as is
+struct CheckpointRecord {
+    std::uint64_t magic;
+    std::uint64_t sequence;        // counts the snapshots of this rank, across restarts
+    std::uint64_t seed;
+    std::uint64_t totalSamples;    // N of the run
+    std::uint64_t localSamples;    // this rank's share of N
+    std::uint64_t samplesDone;
+    std::uint64_t streamPosition;  // doubles drawn from the rank's stream (scalar) or chunks finished (hybrid)
+    double sum;
+    double compensation;
+    std::int32_t rank;
+    std::int32_t size;
+    std::int32_t hybrid;           // 1 if written by the -T kernel, whose streams differ from the scalar sampler's
+    std::int32_t dims;
+    char integrand[16];
+    std::uint64_t checksum;        // FNV-1a of every byte before it
+};
+static_assert(sizeof(CheckpointRecord) == 9 * 8 + 4 * 4 + 16 + 8, "CheckpointRecord must have no padding");
+
+enum CheckpointStatus { CHECKPOINT_NONE, CHECKPOINT_FOUND, CHECKPOINT_MISMATCH };
+
+inline std::uint64_t checkpointChecksum(const CheckpointRecord& record) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&record);
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < offsetof(CheckpointRecord, checksum); ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+inline std::string checkpointPath(const std::string& prefix, int rank, int slot) {
+    return prefix + "." + std::to_string(rank) + (slot == 0 ? ".a" : ".b");
+}
+
+// Record with the parameters of this rank's run and no progress yet
+inline CheckpointRecord checkpointRun(const char* integrand, int dims, std::uint64_t seed, std::uint64_t totalSamples,
+                                      std::uint64_t localSamples, int rank, int size, bool hybrid) {
+    CheckpointRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.magic = CHECKPOINT_MAGIC;
+    record.seed = seed;
+    record.totalSamples = totalSamples;
+    record.localSamples = localSamples;
+    record.rank = rank;
+    record.size = size;
+    record.hybrid = hybrid ? 1 : 0;
+    record.dims = dims;
+    std::strncpy(record.integrand, integrand, sizeof(record.integrand) - 1);
+    return record;
+}
+
+// Snapshot 'sequence' of the run with the progress in 'state'
+inline CheckpointRecord makeCheckpoint(const CheckpointRecord& run, const PartialSum& state, std::uint64_t sequence) {
+    CheckpointRecord record = run;
+    record.sequence = sequence;
+    record.samplesDone = state.done;
+    record.streamPosition = run.hybrid ? (state.done + HYBRID_CHUNK_SAMPLES - 1) / HYBRID_CHUNK_SAMPLES
+                                       : state.done * static_cast<std::uint64_t>(run.dims);
+    record.sum = state.sum;
+    record.compensation = state.compensation;
+    record.checksum = checkpointChecksum(record);
+    return record;
+}
+
+// Newest valid checkpoint of this rank under 'prefix'. CHECKPOINT_MISMATCH if it was written by a different run
+// (integrand, N, seed, number of ranks or kernel), CHECKPOINT_NONE if neither slot holds a valid record.
+inline CheckpointStatus loadCheckpoint(const std::string& prefix, const CheckpointRecord& run, CheckpointRecord& out) {
+    bool found = false;
+    for (int slot = 0; slot < 2; ++slot) {
+        FILE* in = std::fopen(checkpointPath(prefix, run.rank, slot).c_str(), "rb");
+        if (in == nullptr) {
+            continue;
+        }
+        CheckpointRecord record;
+        bool complete = std::fread(&record, sizeof(record), 1, in) == 1 && std::fgetc(in) == EOF;
+        std::fclose(in);
+        if (!complete || record.magic != CHECKPOINT_MAGIC || record.checksum != checkpointChecksum(record)) {
+            continue;  // torn or foreign file: the other slot is used
+        }
+        if (!found || record.sequence > out.sequence) {
+            out = record;
+            found = true;
+        }
+    }
+    if (!found) {
+        return CHECKPOINT_NONE;
+    }
+    bool sameRun = out.seed == run.seed && out.totalSamples == run.totalSamples && out.localSamples == run.localSamples
+                   && out.rank == run.rank && out.size == run.size && out.hybrid == run.hybrid && out.dims == run.dims
+                   && std::strncmp(out.integrand, run.integrand, sizeof(run.integrand)) == 0
+                   && out.samplesDone <= out.localSamples;
+    return sameRun ? CHECKPOINT_FOUND : CHECKPOINT_MISMATCH;
+}
+
+// Background writer of one rank's checkpoints. submit() only copies the record; if the thread is still writing the
+// previous one, the newer record replaces any record still waiting. The destructor writes the last record, then joins.
+class CheckpointWriter {
+public:
+    CheckpointWriter(const std::string& prefix, int rank)
+        : prefix(prefix), rank(rank), pending(false), stopping(false), worker(&CheckpointWriter::run, this) {}
+
+    ~CheckpointWriter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    void submit(const CheckpointRecord& record) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            next = record;
+            pending = true;
+        }
+        wake.notify_one();
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this] { return pending || stopping; });
+            if (!pending) {
+                return;
+            }
+            CheckpointRecord record = next;
+            pending = false;
+            lock.unlock();
+            write(record);
+            lock.lock();
+        }
+    }
+
+    // Slot sequence % 2, flushed to the device before the other slot is touched again
+    void write(const CheckpointRecord& record) {
+        std::string path = checkpointPath(prefix, rank, static_cast<int>(record.sequence % 2));
+        FILE* out = std::fopen(path.c_str(), "wb");
+        bool written = out != nullptr && std::fwrite(&record, sizeof(record), 1, out) == 1 && std::fflush(out) == 0
+                       && fsync(fileno(out)) == 0;
+        if (out != nullptr && std::fclose(out) != 0) {
+            written = false;
+        }
+        if (!written) {
+            std::fprintf(stderr, "Rank %d: cannot write checkpoint %s\n", rank, path.c_str());
+        }
+    }
+
+    std::string prefix;
+    int rank;
+    CheckpointRecord next;
+    bool pending;
+    bool stopping;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread worker;  // last member: starts after everything it reads is initialized
+};
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,164 @@
+/*
+Author: Kamya Hari
+Course: ECE 6122 A
+Last Date Modified: 10/18/2026
+
+Description:
+Dynamic master/worker scheduling for -D <blockSamples>. The N samples are cut into blocks. Rank 0 hands block
+indices out on demand and also computes blocks itself between messages. Every worker holds up to two assigned
+blocks: it posts a non-blocking receive for the next block before computing the current one, so it never waits for
+the dispatcher. A finished block's sum goes back with MPI_Isend, and rank 0 answers it with another block index
+(or with DYNAMIC_STOP once the worker has nothing left).
+Block k always reads the Philox streams (DYNAMIC_STREAM, part, k), one per HYBRID_CHUNK_SAMPLES of the block, and
+rank 0 adds the block sums in block order. The estimate therefore depends only on the seed, not on which rank ran
+which block. Each rank reports its blocks, samples and busy time, from which rank 0 prints samples/sec and the
+balance achieved.
+*/
+
+#ifndef DYNAMIC_SCHEDULER_H
+#define DYNAMIC_SCHEDULER_H
+
+#include <mpi.h>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "hybridSampler.h"
+
+const int DYNAMIC_STREAM = 0x7fffffff;  // Philox rank field of the block streams, never a real rank
+const long long DYNAMIC_STOP = -1;
+const int TAG_ASSIGN = 40;
+const int TAG_RESULT = 41;
+
+struct RankLoad {
+    double blocks;
+    double samples;
+    double busySeconds;  // time spent sampling
+};
+
+struct DynamicResult {
+    double estimate;             // rank 0 only
+    double wallSeconds;
+    std::vector<RankLoad> loads; // rank 0 only, one per rank
+};
+
+// Integrates func on [a, b]^Func::dims from numSamples samples in blocks of blockSamples, scheduled dynamically
+template <typename Func>
+DynamicResult dynamicMonteCarlo(Func func, double a, double b, std::uint64_t numSamples, std::uint64_t blockSamples,
+                                std::uint64_t seed, int rank, MPI_Comm comm) {
+    int size;
+    MPI_Comm_size(comm, &size);
+    const long long numBlocks = static_cast<long long>((numSamples + blockSamples - 1) / blockSamples);
+    RankLoad load = { 0.0, 0.0, 0.0 };
+
+    // Sum of block k, timed into this rank's load
+    auto runBlock = [&](long long k) {
+        std::uint64_t start = static_cast<std::uint64_t>(k) * blockSamples;
+        std::uint64_t count = std::min(blockSamples, numSamples - start);
+        double begin = MPI_Wtime();
+        double sum = hybridBlockSum(func, a, b, count, seed, DYNAMIC_STREAM, static_cast<std::uint32_t>(k));
+        load.busySeconds += MPI_Wtime() - begin;
+        load.blocks += 1.0;
+        load.samples += static_cast<double>(count);
+        return sum;
+    };
+
+    MPI_Barrier(comm);
+    double wallStart = MPI_Wtime();
+    DynamicResult result;
+    result.estimate = 0.0;
+
+    if (rank == 0) {
+        std::vector<double> blockSums(numBlocks, 0.0);
+        std::vector<int> outstanding(size, 0);
+        std::deque<long long> sendBuffers;  // deque: elements stay in place while their Isends are pending
+        std::vector<MPI_Request> sends;
+        long long nextBlock = 0, finished = 0;
+
+        auto assign = [&](int worker) {
+            long long block = nextBlock < numBlocks ? nextBlock++ : DYNAMIC_STOP;
+            if (block != DYNAMIC_STOP) {
+                ++outstanding[worker];
+            }
+            sendBuffers.push_back(block);
+            sends.push_back(MPI_REQUEST_NULL);
+            MPI_Isend(&sendBuffers.back(), 1, MPI_LONG_LONG, worker, TAG_ASSIGN, comm, &sends.back());
+        };
+        // Stores one result and gives the worker its next block; a worker still holding a block gets nothing yet
+        auto handleResult = [&](const MPI_Status& status, const double* message) {
+            int worker = status.MPI_SOURCE;
+            blockSums[static_cast<long long>(message[0])] = message[1];
+            ++finished;
+            --outstanding[worker];
+            if (nextBlock < numBlocks || outstanding[worker] == 0) {
+                assign(worker);
+            }
+        };
+
+        // Two blocks per worker up front: one to compute, one queued
+        for (int round = 0; round < 2; ++round) {
+            for (int worker = 1; worker < size; ++worker) {
+                if (round == 0 || nextBlock < numBlocks) {
+                    assign(worker);
+                }
+            }
+        }
+
+        double message[2];
+        MPI_Status status;
+        while (finished < numBlocks) {
+            int pending = 1;
+            while (pending) {
+                MPI_Iprobe(MPI_ANY_SOURCE, TAG_RESULT, comm, &pending, &status);
+                if (pending) {
+                    MPI_Recv(message, 2, MPI_DOUBLE, status.MPI_SOURCE, TAG_RESULT, comm, &status);
+                    handleResult(status, message);
+                }
+            }
+            if (nextBlock < numBlocks) {
+                long long k = nextBlock++;
+                blockSums[k] = runBlock(k);
+                ++finished;
+            }
+            else if (finished < numBlocks) {
+                MPI_Recv(message, 2, MPI_DOUBLE, MPI_ANY_SOURCE, TAG_RESULT, comm, &status);
+                handleResult(status, message);
+            }
+        }
+        MPI_Waitall(static_cast<int>(sends.size()), sends.data(), MPI_STATUSES_IGNORE);
+
+        double sum = 0.0, compensation = 0.0;
+        for (double s : blockSums) {
+            double total = sum + s;
+            compensation += (std::fabs(sum) >= std::fabs(s)) ? (sum - total) + s : (s - total) + sum;
+            sum = total;
+        }
+        result.estimate = std::pow(b - a, Func::dims) * (sum + compensation) / numSamples;
+    }
+    else {
+        long long current, next;
+        double message[2];
+        MPI_Request resultSend = MPI_REQUEST_NULL, nextReceive;
+        MPI_Recv(&current, 1, MPI_LONG_LONG, 0, TAG_ASSIGN, comm, MPI_STATUS_IGNORE);
+        while (current != DYNAMIC_STOP) {
+            MPI_Irecv(&next, 1, MPI_LONG_LONG, 0, TAG_ASSIGN, comm, &nextReceive);
+            double sum = runBlock(current);
+            MPI_Wait(&resultSend, MPI_STATUS_IGNORE);  // previous result buffer is free again
+            message[0] = static_cast<double>(current);
+            message[1] = sum;
+            MPI_Isend(message, 2, MPI_DOUBLE, 0, TAG_RESULT, comm, &resultSend);
+            MPI_Wait(&nextReceive, MPI_STATUS_IGNORE);
+            current = next;
+        }
+        MPI_Wait(&resultSend, MPI_STATUS_IGNORE);
+    }
+
+    result.wallSeconds = MPI_Wtime() - wallStart;
+    if (rank == 0) {
+        result.loads.resize(size);
+    }
+    MPI_Gather(&load, 3, MPI_DOUBLE, rank == 0 ? result.loads.data() : nullptr, 3, MPI_DOUBLE, 0, comm);
+    return result;
+}
+
+#endif // DYNAMIC_SCHEDULER_H
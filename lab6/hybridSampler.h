@@ -0,0 +1,210 @@
+/*
+Author: Kamya Hari
+Course: ECE 6122 A
+Last Date Modified: 10/18/2026
+
+Description:
+Hybrid MPI + OpenMP + SIMD sampling kernel. A rank's samples are cut into chunks of HYBRID_CHUNK_SAMPLES that OpenMP
+threads process with a static schedule. Inside a chunk, each iteration runs HYBRID_LANES Philox evaluations side by
+side and turns them into 2 * HYBRID_LANES uniforms, which are mapped to [a, b] and passed through the integrand in an
+"omp simd" loop. The integrand is a functor template argument, so it is inlined and vectorized with the loop.
+A d-dimensional integrand gets d such groups per iteration, one per coordinate.
+Chunk c of a rank reads the Philox stream (rank, 0, c) and the chunk sums are added in chunk order, so the estimate
+does not depend on the number of threads. A chunk's 32-bit Philox counter only covers HYBRID_CHUNK_SAMPLES samples, so a
+larger block of the dynamic scheduler or of a job batch is read as parts of that size from the streams (rank, part, block). A run may be done in segments of whole chunks that continue one PartialSum,
+which is what the checkpoints of checkpoint.h save.
+*/
+
+#ifndef HYBRID_SAMPLER_H
+#define HYBRID_SAMPLER_H
+
+#include "philoxRng.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+const int HYBRID_LANES = 8;  // Philox evaluations per iteration, i.e. 16 samples
+const std::uint64_t HYBRID_CHUNK_SAMPLES = std::uint64_t(1) << 20;
+
+// 2 * HYBRID_LANES uniforms from counters {first + lane, block, thread, rank}, in PhiloxStream order.
+// Same rounds as philox4x32, written lane-wise so every round is one vector operation per word.
+inline void philoxUniformLanes(std::uint32_t first, std::uint32_t block, std::uint32_t thread, std::uint32_t rank,
+                               const std::uint32_t key[2], double out[2 * HYBRID_LANES]) {
+    const std::uint32_t M0 = 0xD2511F53u, M1 = 0xCD9E8D57u;
+    const std::uint32_t W0 = 0x9E3779B9u, W1 = 0xBB67AE85u;
+    std::uint32_t c0[HYBRID_LANES], c1[HYBRID_LANES], c2[HYBRID_LANES], c3[HYBRID_LANES];
+    for (int lane = 0; lane < HYBRID_LANES; ++lane) {
+        c0[lane] = first + static_cast<std::uint32_t>(lane);
+        c1[lane] = block;
+        c2[lane] = thread;
+        c3[lane] = rank;
+    }
+
+    std::uint32_t k0 = key[0], k1 = key[1];
+    for (int round = 0; round < 10; ++round) {
+        #ifdef _OPENMP
+        #pragma omp simd
+        #endif
+        for (int lane = 0; lane < HYBRID_LANES; ++lane) {
+            std::uint64_t p0 = static_cast<std::uint64_t>(M0) * c0[lane];
+            std::uint64_t p1 = static_cast<std::uint64_t>(M1) * c2[lane];
+            std::uint32_t n0 = static_cast<std::uint32_t>(p1 >> 32) ^ c1[lane] ^ k0;
+            std::uint32_t n2 = static_cast<std::uint32_t>(p0 >> 32) ^ c3[lane] ^ k1;
+            c1[lane] = static_cast<std::uint32_t>(p1);
+            c3[lane] = static_cast<std::uint32_t>(p0);
+            c0[lane] = n0;
+            c2[lane] = n2;
+        }
+        k0 += W0;
+        k1 += W1;
+    }
+
+    #ifdef _OPENMP
+    #pragma omp simd
+    #endif
+    for (int lane = 0; lane < HYBRID_LANES; ++lane) {
+        // Same value as uniformFromBits; the shifted words fit in int32, which converts to double in one instruction
+        out[2 * lane] = (static_cast<std::int32_t>(c0[lane] >> 5) * 67108864.0 + static_cast<std::int32_t>(c1[lane] >> 6)) * (1.0 / 9007199254740992.0);
+        out[2 * lane + 1] = (static_cast<std::int32_t>(c2[lane] >> 5) * 67108864.0 + static_cast<std::int32_t>(c3[lane] >> 6)) * (1.0 / 9007199254740992.0);
+    }
+}
+
+// Sum of func over 'count' samples of chunk 'chunk' (count <= HYBRID_CHUNK_SAMPLES, so the counter does not wrap) in
+// [a, b]^Func::dims; 'part' selects one of the streams of a block larger than a chunk
+template <typename Func>
+double hybridChunkSum(Func func, double a, double b, std::uint64_t count, std::uint64_t seed, int rank, std::uint32_t chunk,
+                      std::uint32_t part = 0) {
+    const std::uint32_t key[2] = { static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32) };
+    const int group = 2 * HYBRID_LANES;
+    const int dims = Func::dims;
+    double u[dims][group];
+    double sum = 0.0;
+    for (std::uint64_t done = 0; done < count; done += group) {
+        for (int d = 0; d < dims; ++d) {
+            philoxUniformLanes(static_cast<std::uint32_t>((done / group * dims + d) * HYBRID_LANES), chunk, part, rank, key, u[d]);
+        }
+        int valid = static_cast<int>(std::min<std::uint64_t>(group, count - done));
+        #ifdef _OPENMP
+        #pragma omp simd reduction(+:sum)
+        #endif
+        for (int i = 0; i < group; ++i) {
+            double x[dims];
+            for (int d = 0; d < dims; ++d) {
+                x[d] = a + (b - a) * u[d][i];
+            }
+            double value = func(x);
+            sum += (i < valid) ? value : 0.0;
+        }
+    }
+    return sum;
+}
+
+// Sum of func over a block of 'count' samples of any size: parts of HYBRID_CHUNK_SAMPLES, added in part order. A block
+// of at most one chunk reads the same samples as hybridChunkSum.
+template <typename Func>
+double hybridBlockSum(Func func, double a, double b, std::uint64_t count, std::uint64_t seed, int rank, std::uint32_t block) {
+    double sum = 0.0;
+    for (std::uint64_t start = 0, part = 0; start < count; start += HYBRID_CHUNK_SAMPLES, ++part) {
+        sum += hybridChunkSum(func, a, b, std::min(HYBRID_CHUNK_SAMPLES, count - start), seed, rank, block,
+                              static_cast<std::uint32_t>(part));
+    }
+    return sum;
+}
+
+// Same samples as hybridChunkSum, also summing the squares (kept separate so the plain sum loop stays lean)
+template <typename Func>
+void hybridChunkMoments(Func func, double a, double b, std::uint64_t count, std::uint64_t seed, int rank, std::uint32_t chunk,
+                        double& sumOut, double& squaresOut, std::uint32_t part = 0) {
+    const std::uint32_t key[2] = { static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32) };
+    const int group = 2 * HYBRID_LANES;
+    const int dims = Func::dims;
+    double u[dims][group];
+    double sum = 0.0, squares = 0.0;
+    for (std::uint64_t done = 0; done < count; done += group) {
+        for (int d = 0; d < dims; ++d) {
+            philoxUniformLanes(static_cast<std::uint32_t>((done / group * dims + d) * HYBRID_LANES), chunk, part, rank, key, u[d]);
+        }
+        int valid = static_cast<int>(std::min<std::uint64_t>(group, count - done));
+        #ifdef _OPENMP
+        #pragma omp simd reduction(+:sum, squares)
+        #endif
+        for (int i = 0; i < group; ++i) {
+            double x[dims];
+            for (int d = 0; d < dims; ++d) {
+                x[d] = a + (b - a) * u[d][i];
+            }
+            double value = (i < valid) ? func(x) : 0.0;
+            sum += value;
+            squares += value * value;
+        }
+    }
+    sumOut = sum;
+    squaresOut = squares;
+}
+
+// Sum and sum of squares over a block of any size, read in parts like hybridBlockSum
+template <typename Func>
+void hybridBlockMoments(Func func, double a, double b, std::uint64_t count, std::uint64_t seed, int rank, std::uint32_t block,
+                        double& sumOut, double& squaresOut) {
+    sumOut = 0.0;
+    squaresOut = 0.0;
+    for (std::uint64_t start = 0, part = 0; start < count; start += HYBRID_CHUNK_SAMPLES, ++part) {
+        double sum, squares;
+        hybridChunkMoments(func, a, b, std::min(HYBRID_CHUNK_SAMPLES, count - start), seed, rank, block, sum, squares,
+                           static_cast<std::uint32_t>(part));
+        sumOut += sum;
+        squaresOut += squares;
+    }
+}
+
+// Progress of a rank's fixed-N run: samples done so far and their compensated (Kahan-Neumaier) sum
+struct PartialSum {
+    std::uint64_t done;
+    double sum;
+    double compensation;
+};
+
+inline void addCompensated(PartialSum& state, double value) {
+    double total = state.sum + value;
+    state.compensation += (std::fabs(state.sum) >= std::fabs(value)) ? (state.sum - total) + value : (value - total) + state.sum;
+    state.sum = total;
+}
+
+// Integral estimate over [a, b]^dims from a finished PartialSum
+inline double partialEstimate(const PartialSum& state, double a, double b, int dims) {
+    return state.done == 0 ? 0.0 : std::pow(b - a, dims) * (state.sum + state.compensation) / state.done;
+}
+
+// Continues 'state' with the next 'count' samples of this rank using numThreads OpenMP threads. state.done must be a
+// multiple of HYBRID_CHUNK_SAMPLES, and so must count unless the segment ends the run; one call for all samples gives
+// the same sum as any split into segments.
+template <typename Func>
+void hybridMonteCarloSegment(Func func, double a, double b, std::uint64_t count, std::uint64_t seed, int rank, int numThreads,
+                             PartialSum& state) {
+    const std::uint64_t first = state.done / HYBRID_CHUNK_SAMPLES;
+    const std::uint64_t end = state.done + count;
+    std::int64_t numChunks = static_cast<std::int64_t>((count + HYBRID_CHUNK_SAMPLES - 1) / HYBRID_CHUNK_SAMPLES);
+    std::vector<double> chunkSums(numChunks, 0.0);
+    (void)numThreads;  // only read by the OpenMP pragma
+
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
+    #endif
+    for (std::int64_t c = 0; c < numChunks; ++c) {
+        std::uint64_t start = (first + c) * HYBRID_CHUNK_SAMPLES;
+        std::uint64_t samples = std::min(HYBRID_CHUNK_SAMPLES, end - start);
+        chunkSums[c] = hybridChunkSum(func, a, b, samples, seed, rank, static_cast<std::uint32_t>(first + c));
+    }
+
+    // Chunk sums are added in chunk order
+    for (double s : chunkSums) {
+        addCompensated(state, s);
+    }
+    state.done = end;
+}
+
+#endif // HYBRID_SAMPLER_H
@@ -0,0 +1,67 @@
+/*
+Author: Kamya Hari
+Course: ECE 6122 A
+Last Date Modified: 10/18/2026
+
+Description:
+Integrands for the Monte Carlo samplers. Every integrand is a functor with a compile-time dimension 'dims' and an
+operator() that takes a point of that many coordinates, so each sampling loop is instantiated for it and the call
+is inlined. To add an integrand, define its functor here and add one line to the registry in lab6.cpp.
+*/
+
+#ifndef INTEGRANDS_H
+#define INTEGRANDS_H
+
+#include "simdMath.h"
+
+// Integral 1: x^2 on [0, 1] (exact 1/3)
+struct Func1 {
+    static const int dims = 1;
+    double operator()(const double* x) const { return x[0] * x[0]; }
+};
+
+// Integral 2: e^(-x^2) on [0, 1] (exact 0.746824132812427); the vectorizable exp keeps the hybrid loop in SIMD
+struct Func2 {
+    static const int dims = 1;
+    double operator()(const double* x) const { return simdExp(-x[0] * x[0]); }
+};
+
+// e^(-|x|^2) on [0, 1]^3 (exact 0.746824132812427^3 = 0.416538385886638)
+struct Gauss3 {
+    static const int dims = 3;
+    double operator()(const double* x) const { return simdExp(-(x[0] * x[0] + x[1] * x[1] + x[2] * x[2])); }
+};
+
+// Indicator of the unit ball on [-1, 1]^4: the volume of the 4-ball (exact pi^2 / 2 = 4.934802200544679)
+struct Ball4 {
+    static const int dims = 4;
+    double operator()(const double* x) const {
+        return (x[0] * x[0] + x[1] * x[1] + x[2] * x[2] + x[3] * x[3] <= 1.0) ? 1.0 : 0.0;
+    }
+};
+
+// Narrow Gaussian peak at the centre of [0, 1]^6 (exact (sqrt(pi) / 10 * erf(5))^6 = 3.1006276680013794e-05)
+struct Peak6 {
+    static const int dims = 6;
+    double operator()(const double* x) const {
+        double r2 = 0.0;
+        for (int d = 0; d < dims; ++d) {
+            r2 += (x[d] - 0.5) * (x[d] - 0.5);
+        }
+        return simdExp(-100.0 * r2);
+    }
+};
+
+// e^(-|x|^2) on [0, 1]^8 (exact 0.746824132812427^8 = 0.09677133805568514)
+struct Gauss8 {
+    static const int dims = 8;
+    double operator()(const double* x) const {
+        double r2 = 0.0;
+        for (int d = 0; d < dims; ++d) {
+            r2 += x[d] * x[d];
+        }
+        return simdExp(-r2);
+    }
+};
+
+#endif // INTEGRANDS_H
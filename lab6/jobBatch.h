@@ -0,0 +1,251 @@
+/*
+Author: Kamya Hari
+Course: ECE 6122 A
+Last Date Modified: 10/18/2026
+
+Description:
+Batch mode for -J <jobFile>: many integrals in one MPI launch. Every job (integrand, interval, sample count or
+tolerance) is cut into blocks, and the blocks of all jobs form one pipelined stream of work that rank 0 hands out
+on demand. The messages are the same non-blocking ones as dynamicScheduler.h, with a job index added. A worker
+keeps one block queued behind the one it is computing. While a job's last blocks are still out, the dispatcher is
+already handing out the next job's blocks, so no rank waits at a job boundary.
+A fixed-N job is done when all of its blocks are back; its blocks are summed in block order and compensated
+(Kahan-Neumaier, like every fixed-N path), so its estimate does not depend on the schedule and keeps its precision.
+A tolerance job gets more blocks until the standard error of the blocks returned so far is below its tolerance; at
+most one block per rank is outstanding for it at a time, so it overshoots by at most that.
+Rank 0 prints each job's result the moment the job completes.
+*/
+
+#ifndef JOB_BATCH_H
+#define JOB_BATCH_H
+
+#include <mpi.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <vector>
+#include "adaptiveSampler.h"
+#include "hybridSampler.h"
+
+const int JOB_STREAM_BASE = 0x40000000;  // Philox rank field of job j is JOB_STREAM_BASE + j, above every real rank
+const std::uint64_t JOB_MAX_SAMPLES = std::uint64_t(1) << 40;  // cap for tolerance jobs that never converge
+const int TAG_JOB_ASSIGN = 42;
+const int TAG_JOB_RESULT = 43;
+
+// (sum, sum of squares) of func over 'count' samples of block 'block' of stream 'stream', on [a, b]^dims
+typedef void (*BlockMomentsFn)(double a, double b, std::uint64_t count, std::uint64_t seed, int stream,
+                               std::uint32_t block, double& sum, double& squares);
+
+struct BatchJob {
+    const char* name;        // integrand registry name
+    int dims;
+    double lower, upper;     // interval, in every dimension
+    std::uint64_t samples;   // fixed sample count, or 0 for a tolerance job
+    double tolerance;        // target standard error of a tolerance job
+    BlockMomentsFn moments;
+};
+
+// Runs every job and prints the results on rank 0 as they complete; blockSamples is the size of one unit of work
+inline void runJobBatch(const std::vector<BatchJob>& jobs, std::uint64_t blockSamples, std::uint64_t seed, int rank, MPI_Comm comm) {
+    int size;
+    MPI_Comm_size(comm, &size);
+    const double start = MPI_Wtime();
+
+    // Samples in block k of job j
+    auto blockCount = [&](int j, long long k) {
+        std::uint64_t limit = jobs[j].samples > 0 ? jobs[j].samples : JOB_MAX_SAMPLES;
+        return std::min(blockSamples, limit - static_cast<std::uint64_t>(k) * blockSamples);
+    };
+    auto runBlock = [&](int j, long long k, double* out) {
+        const BatchJob& job = jobs[j];
+        std::uint64_t count = blockCount(j, k);
+        job.moments(job.lower, job.upper, count, seed, JOB_STREAM_BASE + j, static_cast<std::uint32_t>(k), out[0], out[1]);
+        out[2] = static_cast<double>(count);
+    };
+
+    if (rank != 0) {
+        // Assignment: {job, block}, job < 0 means stop. Result: {job, block, sum, squares, count}.
+        long long current[2], next[2];
+        double message[5];
+        MPI_Request resultSend = MPI_REQUEST_NULL, nextReceive;
+        MPI_Recv(current, 2, MPI_LONG_LONG, 0, TAG_JOB_ASSIGN, comm, MPI_STATUS_IGNORE);
+        while (current[0] >= 0) {
+            MPI_Irecv(next, 2, MPI_LONG_LONG, 0, TAG_JOB_ASSIGN, comm, &nextReceive);
+            double out[3];
+            runBlock(static_cast<int>(current[0]), current[1], out);
+            MPI_Wait(&resultSend, MPI_STATUS_IGNORE);
+            message[0] = static_cast<double>(current[0]);
+            message[1] = static_cast<double>(current[1]);
+            message[2] = out[0];
+            message[3] = out[1];
+            message[4] = out[2];
+            MPI_Isend(message, 5, MPI_DOUBLE, 0, TAG_JOB_RESULT, comm, &resultSend);
+            MPI_Wait(&nextReceive, MPI_STATUS_IGNORE);
+            current[0] = next[0];
+            current[1] = next[1];
+        }
+        MPI_Wait(&resultSend, MPI_STATUS_IGNORE);
+        return;
+    }
+
+    struct JobState {
+        long long nextBlock = 0;
+        long long outstanding = 0;
+        bool converged = false;       // tolerance job: no further blocks needed
+        bool reported = false;
+        RunningStats stats = { 0.0, 0.0, 0.0 };
+        std::vector<double> blockSums;  // fixed-N job: summed in block order (compensated) at the end
+    };
+    const int numJobs = static_cast<int>(jobs.size());
+    std::vector<JobState> state(numJobs);
+    for (int j = 0; j < numJobs; ++j) {
+        if (jobs[j].samples > 0) {
+            state[j].blockSums.assign((jobs[j].samples + blockSamples - 1) / blockSamples, 0.0);
+        }
+    }
+    int firstOpen = 0, reported = 0;
+    double totalSamples = 0.0;
+
+    // Next (job, block) that may be started now, in job order; false if every open job is waiting on results
+    auto nextUnit = [&](int& job, long long& block) {
+        for (int j = firstOpen; j < numJobs; ++j) {
+            JobState& s = state[j];
+            bool more = jobs[j].samples > 0 ? s.nextBlock < static_cast<long long>(s.blockSums.size())
+                                            : !s.converged && s.outstanding < size
+                                                  && static_cast<std::uint64_t>(s.nextBlock) * blockSamples < JOB_MAX_SAMPLES;
+            if (more) {
+                job = j;
+                block = s.nextBlock++;
+                ++s.outstanding;
+                return true;
+            }
+        }
+        return false;
+    };
+    // Folds one block into its job and prints the job once it is complete
+    auto finishBlock = [&](int j, long long k, const double* out) {
+        JobState& s = state[j];
+        --s.outstanding;
+        totalSamples += out[2];
+        RunningStats block = { out[2], out[0] / out[2], std::max(0.0, out[1] - out[0] * out[0] / out[2]) };
+        mergeStats(s.stats, block);
+        double volume = std::pow(jobs[j].upper - jobs[j].lower, jobs[j].dims);
+        if (jobs[j].samples > 0) {
+            s.blockSums[k] = out[0];
+        }
+        else if (standardError(s.stats, volume) < jobs[j].tolerance
+                 || static_cast<std::uint64_t>(s.nextBlock) * blockSamples >= JOB_MAX_SAMPLES) {
+            s.converged = true;
+        }
+        bool complete = s.outstanding == 0
+                        && (jobs[j].samples > 0 ? s.nextBlock == static_cast<long long>(s.blockSums.size()) : s.converged);
+        if (complete && !s.reported) {
+            double estimate = volume * s.stats.mean;
+            if (jobs[j].samples > 0) {
+                PartialSum sum = { jobs[j].samples, 0.0, 0.0 };
+                for (double b : s.blockSums) {
+                    addCompensated(sum, b);
+                }
+                estimate = partialEstimate(sum, jobs[j].lower, jobs[j].upper, jobs[j].dims);
+            }
+            std::printf("[job %d] %s on [%g, %g]^%d: %.10g +- %.3g (%.0f samples, t = %.3f s)\n", j, jobs[j].name,
+                        jobs[j].lower, jobs[j].upper, jobs[j].dims, estimate, standardError(s.stats, volume),
+                        s.stats.count, MPI_Wtime() - start);
+            std::fflush(stdout);
+            s.reported = true;
+            ++reported;
+            s.blockSums.clear();
+            s.blockSums.shrink_to_fit();
+            while (firstOpen < numJobs && state[firstOpen].reported) {
+                ++firstOpen;
+            }
+        }
+    };
+
+    std::vector<int> outstanding(size, 0);
+    std::vector<int> idle;                    // workers with nothing to do until a tolerance job reports back
+    std::deque<std::array<long long, 2>> sendBuffers;  // deque: elements stay in place while their Isends are pending
+    std::vector<MPI_Request> sends;
+    auto send = [&](int worker, long long job, long long block) {
+        sendBuffers.push_back({ { job, block } });
+        sends.push_back(MPI_REQUEST_NULL);
+        MPI_Isend(sendBuffers.back().data(), 2, MPI_LONG_LONG, worker, TAG_JOB_ASSIGN, comm, &sends.back());
+    };
+    // Gives the worker a block, or parks it (or stops it once every job has been reported)
+    auto feed = [&](int worker) {
+        int job;
+        long long block;
+        if (nextUnit(job, block)) {
+            ++outstanding[worker];
+            send(worker, job, block);
+        }
+        else if (outstanding[worker] == 0) {
+            if (reported == numJobs) {
+                send(worker, -1, 0);
+            }
+            else {
+                idle.push_back(worker);
+            }
+        }
+    };
+    auto handleResult = [&](int worker, const double* message) {
+        --outstanding[worker];
+        finishBlock(static_cast<int>(message[0]), static_cast<long long>(message[1]), message + 2);
+        feed(worker);
+        std::vector<int> waiting;
+        waiting.swap(idle);
+        for (int w : waiting) {
+            feed(w);
+        }
+    };
+
+    for (int round = 0; round < 2; ++round) {
+        for (int worker = 1; worker < size; ++worker) {
+            if (round == 0 || outstanding[worker] > 0) {
+                feed(worker);
+            }
+        }
+    }
+
+    double message[5];
+    MPI_Status status;
+    while (reported < numJobs) {
+        int pending = 1;
+        while (pending) {
+            MPI_Iprobe(MPI_ANY_SOURCE, TAG_JOB_RESULT, comm, &pending, &status);
+            if (pending) {
+                MPI_Recv(message, 5, MPI_DOUBLE, status.MPI_SOURCE, TAG_JOB_RESULT, comm, &status);
+                handleResult(status.MPI_SOURCE, message);
+            }
+        }
+        int job;
+        long long block;
+        if (reported < numJobs && nextUnit(job, block)) {
+            double out[3];
+            runBlock(job, block, out);
+            finishBlock(job, block, out);
+            std::vector<int> waiting;
+            waiting.swap(idle);
+            for (int w : waiting) {
+                feed(w);
+            }
+        }
+        else if (reported < numJobs) {
+            MPI_Recv(message, 5, MPI_DOUBLE, MPI_ANY_SOURCE, TAG_JOB_RESULT, comm, &status);
+            handleResult(status.MPI_SOURCE, message);
+        }
+    }
+    for (int worker : idle) {
+        send(worker, -1, 0);
+    }
+    MPI_Waitall(static_cast<int>(sends.size()), sends.data(), MPI_STATUSES_IGNORE);
+
+    double wall = MPI_Wtime() - start;
+    std::printf("%d jobs, %.0f samples in %.3f s (%.1f jobs/s, %.4g samples/s)\n", numJobs, totalSamples, wall,
+                numJobs / wall, totalSamples / wall);
+}
+
+#endif // JOB_BATCH_H
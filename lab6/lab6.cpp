@@ -7,72 +7,662 @@ Description:
 This program computes two integrals (1 or 2) chosen by the user using Monte carlo estimation. This program also uses OpenMPI to distribute the work across available processors. 
 The program takes in two inputs - P: 1 or 2, to choose the intergral we want to compute; N is the number of random samples to be generated in total that would be distributed across
 processors.
+Random numbers come from counter-based Philox streams (philoxRng.h), one per (rank, thread, block), keyed by --seed,
+so the estimate is bit-identical across runs with the same seed and number of processes.
+With -T <threads> the hybrid kernel (hybridSampler.h) runs OpenMP threads inside each rank and evaluates 16 samples
+per SIMD iteration, so a run can use one rank per node or socket instead of one rank per core. Only the fixed-N run
+is threaded; every other mode rejects -T.
+With -E <tolerance> the ranks sample in batches until the standard error of the estimate is below the tolerance
+(adaptiveSampler.h); -N is then an optional cap on the total samples, and the 95% confidence interval is printed.
+-S sobol|halton replaces the pseudo-random draws by R (-R) independently scrambled low-discrepancy point sets of N / R
+points each (qmcSampler.h); the spread of the R estimates gives the standard error.
+-K <strata>, -A (antithetic), -C (control variate) and -I <proposal> (importance sampling) combine into one
+variance-reduced estimator (varianceReduction.h) that reports the variance reduction factor of every selected option.
+Sample counts are 64-bit: the N % size leftover samples go one each to the first ranks, the per-rank sums are
+compensated (Kahan-Neumaier), and the final estimate weights every rank by the number of samples it drew.
+Integrands are functors (integrands.h) listed in a registry; -P <name> looks the integrand up once and runs the
+sampling loops instantiated for its functor, so the integrand is inlined instead of called through a pointer.
+-M vegas|miser integrates a d-dimensional integrand with VEGAS grid refinement or MISER recursive stratification
+(vegasMiser.h), with the calls of every iteration or region shared by all ranks.
+-D <blockSamples> schedules blocks of samples dynamically (dynamicScheduler.h): rank 0 hands them out on demand, so
+faster ranks take more blocks, and the per-rank samples/sec and load balance are printed.
+-J <jobFile> runs many (integrand, interval, samples or tolerance) jobs in one launch as a single pipelined stream of
+blocks (jobBatch.h) and prints every result as soon as its job completes.
+--timing adds a "Timing:" line to a fixed-N run with its startup, sampling and reduction times and the samples/sec;
+scalingBenchmark.cpp launches lab6 with it over a range of rank counts.
+--checkpoint <prefix> makes every rank of a fixed-N run save its progress every --checkpoint-interval seconds from a
+background thread (checkpoint.h); after a crash or preemption, the same command with --resume continues from there.
 */
 
 #include <mpi.h>
 #include <iostream>
+#include <cstdio>
 #include <cmath>
+#include <algorithm>
 #include <cstdlib>
-#include <ctime>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <type_traits>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <memory>
+#include "philoxRng.h"
+#include "hybridSampler.h"
+#include "adaptiveSampler.h"
+#include "qmcSampler.h"
+#include "varianceReduction.h"
+#include "vegasMiser.h"
+#include "dynamicScheduler.h"
+#include "jobBatch.h"
+#include "checkpoint.h"
+#include "integrands.h"
 
-//Integral 1 - computes integral 1 function
-double func1(double x) {
-    return x * x;
+const char* integrandName = nullptr; //registry name of the integral to compute (-P)
+std::uint64_t N = 0; //total number of samples
+std::uint64_t seed = 6122; //key of the Philox streams
+int numThreads = 0; //OpenMP threads per rank for the hybrid kernel (0: scalar single-threaded sampler)
+double tolerance = 0.0; //target standard error for the adaptive mode (0: fixed N)
+std::uint64_t batchSamples = 65536; //samples per rank between two convergence checks in the adaptive mode
+SamplerKind sampler = SAMPLER_RANDOM; //point generator (-S)
+int replicates = 16; //independent scramblings of a QMC run (-R)
+VarianceReductionOptions reduction = { 1, false, false, { PROPOSAL_UNIFORM, 0.0 } }; //-K, -A, -C, -I
+bool reduceVariance = false; //any of -K, -A, -C, -I given
+AdaptiveMethod method = METHOD_NONE; //-M vegas|miser
+int iterations = 10; //VEGAS iterations (--iterations); -N is split evenly between them
+std::uint64_t dynamicBlock = 0; //samples per dynamically scheduled block (-D; 0: static split)
+const char* jobFile = nullptr; //batch job file (-J)
+bool timing = false; //print the per-phase times of a fixed-N run (--timing)
+const char* checkpointPrefix = nullptr; //checkpoint files are <prefix>.<rank>.a|b (--checkpoint; nullptr: none)
+double checkpointInterval = 600.0; //seconds between two checkpoints of a rank (--checkpoint-interval)
+bool resume = false; //continue from the newest checkpoints (--resume)
+
+//Monte carlo function - takes in the integrand functor, limit values of [a, b]^dims, the number of samples and the stream identity (seed, rank);
+//continues the rank's partial sum with the next numSamples samples, reading the stream from where the previous ones stopped
+//The running sum is compensated (Kahan-Neumaier), so 10^12 samples lose no more precision than a handful would
+template <typename Func>
+void monteCarloSegment(Func func, double a, double b, std::uint64_t numSamples, std::uint64_t seed, int rank, PartialSum& state) {
+    BlockedPhiloxStream rng(seed, rank);
+    rng.seek(state.done * Func::dims);
+    double x[Func::dims];
+    double sum = state.sum, compensation = state.compensation;
+    for (std::uint64_t i = 0; i < numSamples; ++i) {
+        for (int d = 0; d < Func::dims; ++d) {
+            x[d] = a + (b - a) * rng.nextUniform();
+        }
+        double value = func(x);
+        double total = sum + value;
+        compensation += (std::fabs(sum) >= std::fabs(value)) ? (sum - total) + value : (value - total) + sum;
+        sum = total;
+    }
+    state.done += numSamples;
+    state.sum = sum;
+    state.compensation = compensation;
+}
+
+//One registered integrand: name, domain [lower, upper]^dims and every sampling loop instantiated for its functor
+struct IntegrandEntry {
+    const char* name;
+    const char* description;
+    int dims;
+    double lower, upper;
+    void (*fixed)(double, double, std::uint64_t, std::uint64_t, int, PartialSum&);
+    void (*hybrid)(double, double, std::uint64_t, std::uint64_t, int, int, PartialSum&);
+    AdaptiveResult (*adaptive)(double, double, double, std::uint64_t, double, std::uint64_t, int, MPI_Comm);
+    QmcResult (*qmc)(double, double, SamplerKind, std::uint64_t, int, std::uint64_t, int, MPI_Comm);
+    VarianceReductionResult (*reduced)(double, double, const VarianceReductionOptions&, std::uint64_t, std::uint64_t, int, MPI_Comm); //nullptr unless dims == 1
+    MultiDimResult (*vegas)(double, double, int, std::uint64_t, std::uint64_t, int, MPI_Comm);
+    MultiDimResult (*miser)(double, double, std::uint64_t, std::uint64_t, int, MPI_Comm);
+    DynamicResult (*dynamic)(double, double, std::uint64_t, std::uint64_t, std::uint64_t, int, MPI_Comm);
+    BlockMomentsFn moments;
+};
+
+template <typename Func>
+void runFixed(double a, double b, std::uint64_t n, std::uint64_t seed, int rank, PartialSum& state) {
+    monteCarloSegment(Func(), a, b, n, seed, rank, state);
+}
+template <typename Func>
+void runHybrid(double a, double b, std::uint64_t n, std::uint64_t seed, int rank, int threads, PartialSum& state) {
+    hybridMonteCarloSegment(Func(), a, b, n, seed, rank, threads, state);
+}
+template <typename Func>
+AdaptiveResult runAdaptive(double a, double b, double tol, std::uint64_t batch, double maxSamples, std::uint64_t seed, int rank, MPI_Comm comm) {
+    return adaptiveMonteCarlo(Func(), a, b, tol, batch, maxSamples, seed, rank, comm);
+}
+template <typename Func>
+QmcResult runQmc(double a, double b, SamplerKind kind, std::uint64_t points, int reps, std::uint64_t seed, int rank, MPI_Comm comm) {
+    return qmcMonteCarlo(Func(), a, b, kind, points, reps, seed, rank, comm);
+}
+template <typename Func>
+VarianceReductionResult runReduced(double a, double b, const VarianceReductionOptions& options, std::uint64_t n, std::uint64_t seed, int rank, MPI_Comm comm) {
+    return varianceReducedMonteCarlo(Func(), a, b, options, n, seed, rank, comm);
+}
+template <typename Func>
+MultiDimResult runVegas(double a, double b, int iters, std::uint64_t calls, std::uint64_t seed, int rank, MPI_Comm comm) {
+    return vegasIntegrate(Func(), a, b, iters, calls, seed, rank, comm);
+}
+template <typename Func>
+MultiDimResult runMiser(double a, double b, std::uint64_t calls, std::uint64_t seed, int rank, MPI_Comm comm) {
+    return miserIntegrate(Func(), a, b, calls, seed, rank, comm);
+}
+template <typename Func>
+DynamicResult runDynamic(double a, double b, std::uint64_t n, std::uint64_t block, std::uint64_t seed, int rank, MPI_Comm comm) {
+    return dynamicMonteCarlo(Func(), a, b, n, block, seed, rank, comm);
+}
+template <typename Func>
+void runMoments(double a, double b, std::uint64_t count, std::uint64_t seed, int stream, std::uint32_t block, double& sum, double& squares) {
+    hybridBlockMoments(Func(), a, b, count, seed, stream, block, sum, squares);
 }
+template <typename Func>
+decltype(IntegrandEntry::reduced) reducedRunner(std::true_type) { return &runReduced<Func>; }
+template <typename Func>
+decltype(IntegrandEntry::reduced) reducedRunner(std::false_type) { return nullptr; }
 
-//Integral 2 - computes integral 2 function
-double func2(double x) {
-    return exp(-x * x);
+template <typename Func>
+IntegrandEntry makeIntegrand(const char* name, double lower, double upper, const char* description) {
+    return { name, description, Func::dims, lower, upper, &runFixed<Func>, &runHybrid<Func>, &runAdaptive<Func>, &runQmc<Func>,
+             reducedRunner<Func>(std::integral_constant<bool, Func::dims == 1>()), &runVegas<Func>, &runMiser<Func>,
+             &runDynamic<Func>, &runMoments<Func> };
 }
 
-//Monte carlo function - takes in the function, limit values and the number of samples for which to compute the integral; outputs the integral estimate
-double monteCarlo(double (*func)(double), double a, double b, int numSamples) {
-    double sum = 0.0;
-    for (int i = 0; i < numSamples; ++i) {
-        double x = a + (b - a) * ((double) rand() / RAND_MAX);
-        sum += func(x);
+//Integrand registry - one line per integrand
+const IntegrandEntry integrands[] = {
+    makeIntegrand<Func1>("1", 0.0, 1.0, "x^2 on [0, 1]"),
+    makeIntegrand<Func2>("2", 0.0, 1.0, "exp(-x^2) on [0, 1]"),
+    makeIntegrand<Gauss3>("gauss3", 0.0, 1.0, "exp(-|x|^2) on [0, 1]^3"),
+    makeIntegrand<Ball4>("ball4", -1.0, 1.0, "volume of the unit 4-ball, on [-1, 1]^4"),
+    makeIntegrand<Peak6>("peak6", 0.0, 1.0, "exp(-100 |x - 0.5|^2) on [0, 1]^6"),
+    makeIntegrand<Gauss8>("gauss8", 0.0, 1.0, "exp(-|x|^2) on [0, 1]^8"),
+};
+
+//Registry entry called 'name', or nullptr
+const IntegrandEntry* findIntegrand(const char* name) {
+    for (const IntegrandEntry& entry : integrands) {
+        if (strcmp(entry.name, name) == 0) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+//Samples of 'rank' when 'total' samples are split over 'size' ranks; the first total % size ranks take one extra
+std::uint64_t localSampleCount(std::uint64_t total, int size, int rank) {
+    return total / size + (static_cast<std::uint64_t>(rank) < total % size ? 1 : 0);
+}
+
+//Parses a sample count such as 1000000 or 1e12; returns false unless it is a whole number in [1, 2^63]
+bool parseSampleCount(const char* text, std::uint64_t& count) {
+    char* end;
+    errno = 0;
+    unsigned long long value = strtoull(text, &end, 10);
+    if (*end == 'e' || *end == 'E' || *end == '.') {
+        double real = strtod(text, &end);
+        if (*end != '\0' || !(real >= 1.0 && real <= 9223372036854775808.0) || real != std::floor(real)) {
+            return false;
+        }
+        count = static_cast<std::uint64_t>(real);
+        return true;
+    }
+    if (*end != '\0' || errno == ERANGE || text[0] == '-' || value == 0 || value > (1ULL << 63)) {
+        return false;
     }
-    return (b - a) * sum / numSamples;
+    count = value;
+    return true;
+}
+
+//Parses a job file: one job per line, "<integrand> <lower> <upper> <samples>" or "<integrand> <lower> <upper> tol=<t>",
+//'#' starts a comment. Returns false and sets 'error' on the first bad line.
+bool parseJobs(const std::string& text, std::vector<BatchJob>& jobs, std::string& error) {
+    std::istringstream lines(text);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(lines, line)) {
+        ++lineNumber;
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::string name, amount, extra;
+        BatchJob job;
+        if (!(fields >> name)) {
+            continue; //blank or comment line
+        }
+        const IntegrandEntry* entry = findIntegrand(name.c_str());
+        bool ok = entry != nullptr && (fields >> job.lower >> job.upper >> amount) && !(fields >> extra) && job.upper > job.lower;
+        if (ok) {
+            job.name = entry->name;
+            job.dims = entry->dims;
+            job.moments = entry->moments;
+            job.samples = 0;
+            job.tolerance = 0.0;
+            if (amount.compare(0, 4, "tol=") == 0) {
+                job.tolerance = atof(amount.c_str() + 4);
+                ok = job.tolerance > 0.0;
+            }
+            else {
+                ok = parseSampleCount(amount.c_str(), job.samples);
+            }
+        }
+        if (!ok) {
+            error = "line " + std::to_string(lineNumber) + ": expected <integrand> <lower> <upper> <samples|tol=t>, got \"" + line + "\"";
+            return false;
+        }
+        jobs.push_back(job);
+    }
+    if (jobs.empty()) {
+        error = "no jobs";
+        return false;
+    }
+    return true;
+}
+
+//Parses -P <name> (-N <numSamples> | -E <tolerance> [-N <maxSamples>] [-B <batch>]) [--seed <seed>] [-T <threads>]
+//[-S random|sobol|halton] [-R <replicates>] [-K <strata>] [-A] [-C] [-I <proposal>] [-M vegas|miser [--iterations <k>]]
+//[-D <blockSamples>] | -J <jobFile> [-D <blockSamples>] [--seed <seed>]; returns false on malformed input
+bool parseArguments(int argc, char* argv[]) {
+    bool haveP = false, haveN = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-P") == 0 && i + 1 < argc) {
+            integrandName = argv[++i];
+            haveP = findIntegrand(integrandName) != nullptr;
+        }
+        else if (strcmp(argv[i], "-N") == 0 && i + 1 < argc) {
+            if (!parseSampleCount(argv[++i], N)) {
+                return false;
+            }
+            haveN = true;
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 0);
+        }
+        else if (strcmp(argv[i], "-T") == 0 && i + 1 < argc) {
+            numThreads = atoi(argv[++i]);
+#ifdef _OPENMP
+            if (numThreads <= 0) {
+                numThreads = omp_get_max_threads();
+            }
+#else
+            numThreads = 1; //built without OpenMP: the hybrid kernel still vectorizes on one thread
+#endif
+        }
+        else if (strcmp(argv[i], "-E") == 0 && i + 1 < argc) {
+            tolerance = atof(argv[++i]);
+            if (tolerance <= 0.0) {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], "-B") == 0 && i + 1 < argc) {
+            long long batch = atoll(argv[++i]);
+            if (batch < 2) {
+                return false;
+            }
+            batchSamples = static_cast<std::uint64_t>(batch);
+        }
+        else if (strcmp(argv[i], "-S") == 0 && i + 1 < argc) {
+            ++i;
+            if (strcmp(argv[i], "random") == 0) sampler = SAMPLER_RANDOM;
+            else if (strcmp(argv[i], "sobol") == 0) sampler = SAMPLER_SOBOL;
+            else if (strcmp(argv[i], "halton") == 0) sampler = SAMPLER_HALTON;
+            else return false;
+        }
+        else if (strcmp(argv[i], "-R") == 0 && i + 1 < argc) {
+            replicates = atoi(argv[++i]);
+            if (replicates < 2) {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], "-K") == 0 && i + 1 < argc) {
+            reduction.strata = atoi(argv[++i]);
+            reduceVariance = true;
+            if (reduction.strata < 1) {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], "-A") == 0) {
+            reduction.antithetic = true;
+            reduceVariance = true;
+        }
+        else if (strcmp(argv[i], "-C") == 0) {
+            reduction.controlVariate = true;
+            reduceVariance = true;
+        }
+        else if (strcmp(argv[i], "-I") == 0 && i + 1 < argc) {
+            reduceVariance = true;
+            if (!parseProposal(argv[++i], reduction.proposal)) {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], "-M") == 0 && i + 1 < argc) {
+            ++i;
+            if (strcmp(argv[i], "vegas") == 0) method = METHOD_VEGAS;
+            else if (strcmp(argv[i], "miser") == 0) method = METHOD_MISER;
+            else return false;
+        }
+        else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+            if (iterations < 1) {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], "-D") == 0 && i + 1 < argc) {
+            if (!parseSampleCount(argv[++i], dynamicBlock)) {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], "-J") == 0 && i + 1 < argc) {
+            jobFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--timing") == 0) {
+            timing = true;
+        }
+        else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+            checkpointPrefix = argv[++i];
+        }
+        else if (strcmp(argv[i], "--checkpoint-interval") == 0 && i + 1 < argc) {
+            checkpointInterval = atof(argv[++i]);
+            if (checkpointInterval <= 0.0) {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], "--resume") == 0) {
+            resume = true;
+        }
+        else {
+            return false;
+        }
+    }
+    if ((timing || checkpointPrefix != nullptr || numThreads > 0) && (jobFile != nullptr || dynamicBlock > 0 || method != METHOD_NONE
+                                                                      || reduceVariance || sampler != SAMPLER_RANDOM || tolerance > 0.0)) {
+        return false; //only the fixed-N run is threaded, timed and checkpointed
+    }
+    if (resume && checkpointPrefix == nullptr) {
+        return false;
+    }
+    if (jobFile != nullptr) {
+        return !haveP && !haveN && tolerance == 0.0 && sampler == SAMPLER_RANDOM && !reduceVariance && method == METHOD_NONE;
+    }
+    if (dynamicBlock > 0) {
+        return haveP && haveN && tolerance == 0.0 && sampler == SAMPLER_RANDOM && !reduceVariance && method == METHOD_NONE
+               && N / dynamicBlock < (1ULL << 32);
+    }
+    if (method != METHOD_NONE) {
+        return haveP && haveN && tolerance == 0.0 && sampler == SAMPLER_RANDOM && !reduceVariance
+               && N / iterations >= 2;
+    }
+    if (reduceVariance) {
+        return haveP && haveN && findIntegrand(integrandName)->reduced != nullptr && tolerance == 0.0 && sampler == SAMPLER_RANDOM;
+    }
+    if (sampler != SAMPLER_RANDOM) {
+        return haveP && haveN && tolerance == 0.0 && N >= static_cast<std::uint64_t>(replicates);
+    }
+    if (tolerance > 0.0) {
+        return haveP;
+    }
+    return haveP && haveN;
 }
 
 int main(int argc, char* argv[]) {
-  MPI_Init(&argc, &argv); //Initialize MPI
+    auto processStart = std::chrono::steady_clock::now(); //MPI_Wtime is not available before MPI_Init
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided); //Initialize MPI; only the main thread makes MPI calls
 
     int rank, size;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
 
     // Process command-line arguments
-    if (argc != 5) {
+    if (!parseArguments(argc, argv)) {
         if (rank == 0) {
-            std::cerr << "Usage: " << argv[0] << " -P <1|2> -N <numSamples>\n";
+            std::cerr << "Usage: " << argv[0] << " -P <integrand> -N <numSamples> [--seed <seed>] [-T <threads>] [--timing]\n"
+                      << "       " << argv[0] << " -P <integrand> -N <numSamples> [-T <threads>] --checkpoint <prefix> [--checkpoint-interval <seconds>] [--resume]\n"
+                      << "       " << argv[0] << " -P <integrand> -E <tolerance> [-N <maxSamples>] [-B <batchPerRank>] [--seed <seed>]\n"
+                      << "       " << argv[0] << " -P <integrand> -N <numSamples> -S <sobol|halton> [-R <replicates>] [--seed <seed>]\n"
+                      << "       " << argv[0] << " -P <1-D integrand> -N <numSamples> [-K <strata>] [-A] [-C] [-I uniform|linear:<s>|exp:<lambda>] [--seed <seed>]\n"
+                      << "       " << argv[0] << " -P <integrand> -N <numCalls> -M <vegas|miser> [--iterations <k>] [--seed <seed>]\n"
+                      << "       " << argv[0] << " -P <integrand> -N <numSamples> -D <blockSamples> [--seed <seed>]\n"
+                      << "       " << argv[0] << " -J <jobFile> [-D <blockSamples>] [--seed <seed>]\n"
+                      << "Integrands:\n";
+            for (const IntegrandEntry& entry : integrands) {
+                std::cerr << "  " << entry.name << " - " << entry.description << "\n";
+            }
         }
         MPI_Finalize();
         return 1;
     }
 
-    //Parse through the command line values
-    int P = atoi(argv[2]);
-    int N = atoi(argv[4]);
-    int localSamples = N / size;
-    double a = 0.0, b = 1.0; //Integral range
+    // Batch mode: rank 0 reads the job file and shares it, every rank parses the same text
+    if (jobFile != nullptr) {
+        std::string text;
+        long long length = -1;
+        if (rank == 0) {
+            std::ifstream in(jobFile, std::ios::binary);
+            if (in) {
+                std::ostringstream content;
+                content << in.rdbuf();
+                text = content.str();
+                length = static_cast<long long>(text.size());
+            }
+        }
+        MPI_Bcast(&length, 1, MPI_LONG_LONG, 0, MPI_COMM_WORLD);
+        if (length < 0) {
+            if (rank == 0) {
+                std::cerr << "Cannot read job file " << jobFile << "\n";
+            }
+            MPI_Finalize();
+            return 1;
+        }
+        text.resize(length);
+        MPI_Bcast(&text[0], static_cast<int>(length), MPI_CHAR, 0, MPI_COMM_WORLD);
+
+        std::vector<BatchJob> jobs;
+        std::string error;
+        if (!parseJobs(text, jobs, error)) {
+            if (rank == 0) {
+                std::cerr << jobFile << ": " << error << "\n";
+            }
+            MPI_Finalize();
+            return 1;
+        }
+        runJobBatch(jobs, dynamicBlock > 0 ? dynamicBlock : 65536, seed, rank, MPI_COMM_WORLD);
+        if (rank == 0) {
+            std::cout << "Bye!" << std::endl;
+        }
+        MPI_Finalize();
+        return 0;
+    }
+
+    // Select the integrand once; everything below calls the loops instantiated for its functor
+    const IntegrandEntry& integrand = *findIntegrand(integrandName);
+    double a = integrand.lower, b = integrand.upper; //Integral range in every dimension
+
+    // Adaptive mode: sample until the standard error is below the tolerance
+    if (tolerance > 0.0) {
+        AdaptiveResult result = integrand.adaptive(a, b, tolerance, batchSamples, static_cast<double>(N), seed, rank, MPI_COMM_WORLD);
+        if (rank == 0) {
+            double halfWidth = 1.96 * result.stdError;
+            std::cout << "The estimate for integral " << integrand.name << " is " << result.estimate << "\n";
+            std::cout << "Standard error " << result.stdError << (result.stdError < tolerance ? " (target " : " (target NOT reached, ")
+                      << tolerance << ")\n";
+            std::cout << "95% confidence interval [" << result.estimate - halfWidth << ", " << result.estimate + halfWidth << "]\n";
+            std::cout << "Samples used: " << static_cast<std::uint64_t>(result.samples) << " in " << result.rounds << " batches per rank\n";
+            std::cout << "Bye!" << std::endl;
+        }
+        MPI_Finalize();
+        return 0;
+    }
+
+    // Quasi-Monte Carlo: R scrambled copies of the first N / R points, sliced across the ranks
+    if (sampler != SAMPLER_RANDOM) {
+        std::uint64_t points = N / replicates;
+        QmcResult result = integrand.qmc(a, b, sampler, points, replicates, seed, rank, MPI_COMM_WORLD);
+        if (rank == 0) {
+            std::cout << "The estimate for integral " << integrand.name << " is " << result.estimate << "\n";
+            std::cout << "Standard error " << result.stdError << " from " << replicates << " scrambled "
+                      << (sampler == SAMPLER_SOBOL ? "Sobol" : "Halton") << " replicates of " << points << " points\n";
+            std::cout << "Bye!" << std::endl;
+        }
+        MPI_Finalize();
+        return 0;
+    }
+
+    // Dynamic scheduling: rank 0 hands out blocks on demand, then prints the load of every rank
+    if (dynamicBlock > 0) {
+        DynamicResult result = integrand.dynamic(a, b, N, dynamicBlock, seed, rank, MPI_COMM_WORLD);
+        if (rank == 0) {
+            std::cout << "The estimate for integral " << integrand.name << " is " << result.estimate << "\n";
+            std::cout << "rank  blocks      samples   busy(s)   samples/sec  busy/wall\n";
+            double maxBusy = 0.0, sumBusy = 0.0;
+            for (int r = 0; r < size; ++r) {
+                const RankLoad& load = result.loads[r];
+                std::printf("%4d %7.0f %12.0f %9.3f %13.4g %9.1f%%\n", r, load.blocks, load.samples, load.busySeconds,
+                            load.busySeconds > 0.0 ? load.samples / load.busySeconds : 0.0, 100.0 * load.busySeconds / result.wallSeconds);
+                maxBusy = std::max(maxBusy, load.busySeconds);
+                sumBusy += load.busySeconds;
+            }
+            std::printf("Wall time %.3f s, load balance (mean/max busy time) %.1f%%\n", result.wallSeconds,
+                        maxBusy > 0.0 ? 100.0 * sumBusy / size / maxBusy : 100.0);
+            std::cout << "Bye!" << std::endl;
+        }
+        MPI_Finalize();
+        return 0;
+    }
 
-    // Select the function
-    double (*selectedFunc)(double) = (P == 1) ? func1 : func2;
+    // VEGAS / MISER: adaptive d-dimensional integration, calls shared by all ranks
+    if (method != METHOD_NONE) {
+        MultiDimResult result = (method == METHOD_VEGAS) ? integrand.vegas(a, b, iterations, N / iterations, seed, rank, MPI_COMM_WORLD)
+                                                         : integrand.miser(a, b, N, seed, rank, MPI_COMM_WORLD);
+        if (rank == 0) {
+            std::cout << "The estimate for integral " << integrand.name << " is " << result.estimate << "\n";
+            std::cout << "Standard error " << result.stdError << " from " << static_cast<std::uint64_t>(result.calls) << " calls";
+            if (method == METHOD_VEGAS) {
+                std::cout << " in " << iterations << " VEGAS iterations, chi^2/dof " << result.chi2PerDof;
+            }
+            else {
+                std::cout << " (MISER)";
+            }
+            std::cout << "\n" << "Bye!" << std::endl;
+        }
+        MPI_Finalize();
+        return 0;
+    }
 
-    // Seed random number generator
-    srand(time(nullptr) + rank);
+    // Variance-reduced estimator with every selected option, then one VRF line per option
+    if (reduceVariance) {
+        VarianceReductionResult result = integrand.reduced(a, b, reduction, N, seed, rank, MPI_COMM_WORLD);
+        if (rank == 0) {
+            std::cout << "The estimate for integral " << integrand.name << " is " << result.estimate << "\n";
+            std::cout << "Standard error " << result.stdError << " from " << static_cast<std::uint64_t>(result.evaluations) << " evaluations\n";
+            if (reduction.proposal.kind != PROPOSAL_UNIFORM) {
+                std::cout << "VRF importance sampling: " << result.plainVariance / result.isVariance << "\n";
+            }
+            if (reduction.strata > 1) {
+                std::cout << "VRF stratification (" << reduction.strata << " strata): " << result.isVariance / result.strataVariance << "\n";
+            }
+            if (reduction.antithetic) {
+                std::cout << "VRF antithetic variates: " << result.strataVariance / result.antitheticVariance << "\n";
+            }
+            if (reduction.controlVariate) {
+                std::cout << "VRF control variate: " << result.antitheticVariance / result.finalVariance << "\n";
+            }
+            std::cout << "VRF total vs plain sampling: " << result.plainVariance / result.finalVariance << "\n";
+            std::cout << "Bye!" << std::endl;
+        }
+        MPI_Finalize();
+        return 0;
+    }
 
-    // Perform local computation
-    double localResult = monteCarlo(selectedFunc, a, b, localSamples);
+    std::uint64_t localSamples = localSampleCount(N, size, rank);
 
-    // Gather results from all processes
+    // Restart: every rank continues from its own newest checkpoint, or from the beginning if it has none
+    PartialSum partial = { 0, 0.0, 0.0 };
+    CheckpointRecord checkpointParameters = checkpointRun(integrand.name, integrand.dims, seed, N, localSamples, rank, size, numThreads > 0);
+    std::uint64_t checkpointSequence = 0;
+    if (resume) {
+        CheckpointRecord saved;
+        CheckpointStatus status = loadCheckpoint(checkpointPrefix, checkpointParameters, saved);
+        int mismatch = status == CHECKPOINT_MISMATCH, anyMismatch;
+        MPI_Allreduce(&mismatch, &anyMismatch, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+        if (anyMismatch) {
+            if (rank == 0) {
+                std::cerr << "Checkpoint " << checkpointPrefix << " belongs to a different run (integrand, -N, --seed, ranks or -T)\n";
+            }
+            MPI_Finalize();
+            return 1;
+        }
+        if (status == CHECKPOINT_FOUND) {
+            partial = { saved.samplesDone, saved.sum, saved.compensation };
+            checkpointSequence = saved.sequence + 1;
+        }
+        std::uint64_t resumed = partial.done, totalResumed = 0;
+        MPI_Reduce(&resumed, &totalResumed, 1, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+        if (rank == 0) {
+            std::cout << "Resuming with " << totalResumed << " of " << N << " samples already done\n";
+        }
+    }
+
+    // Phase times of this rank: startup (process start to here), sampling, reduction
+    double phases[3];
+    phases[0] = std::chrono::duration<double>(std::chrono::steady_clock::now() - processStart).count();
+    if (timing) {
+        MPI_Barrier(MPI_COMM_WORLD); //all ranks start sampling together
+    }
+    double phaseStart = MPI_Wtime();
+
+    // Perform local computation on this rank's own Philox streams; with checkpoints, in segments between which the
+    // elapsed time is checked and a snapshot handed to the writer thread
+    {
+        std::unique_ptr<CheckpointWriter> writer;
+        std::uint64_t segment = localSamples;
+        if (checkpointPrefix != nullptr) {
+            writer.reset(new CheckpointWriter(checkpointPrefix, rank));
+            segment = numThreads > 0 ? CHECKPOINT_SEGMENT_CHUNKS * numThreads * HYBRID_CHUNK_SAMPLES : CHECKPOINT_SEGMENT_SAMPLES;
+        }
+        double lastCheckpoint = MPI_Wtime();
+        while (partial.done < localSamples) {
+            std::uint64_t count = std::min(segment, localSamples - partial.done);
+            if (numThreads > 0) {
+                integrand.hybrid(a, b, count, seed, rank, numThreads, partial);
+            }
+            else {
+                integrand.fixed(a, b, count, seed, rank, partial);
+            }
+            if (writer && (MPI_Wtime() - lastCheckpoint >= checkpointInterval || partial.done == localSamples)) {
+                writer->submit(makeCheckpoint(checkpointParameters, partial, checkpointSequence++));
+                lastCheckpoint = MPI_Wtime();
+            }
+        }
+    } //the writer's destructor waits until the last snapshot is on disk
+    double localResult = partialEstimate(partial, a, b, integrand.dims);
+    double samplingEnd = MPI_Wtime();
+    phases[1] = samplingEnd - phaseStart;
+
+    // Gather results from all processes, weighting every rank by its share of the samples
+    double weightedResult = localResult * (static_cast<double>(localSamples) / static_cast<double>(N));
     double globalResult = 0.0;
-    MPI_Reduce(&localResult, &globalResult, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&weightedResult, &globalResult, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    phases[2] = MPI_Wtime() - samplingEnd;
+
+    // Slowest startup and sampling, mean sampling, and the reduction time of the rank that arrived last (the others
+    // also wait for it in MPI_Reduce, which is load imbalance rather than communication)
+    double slowest[3], fastest[3], total[3];
+    if (timing) {
+        MPI_Reduce(phases, slowest, 3, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        MPI_Reduce(phases, fastest, 3, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
+        MPI_Reduce(phases, total, 3, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    }
 
     // Output the result
     if (rank == 0) {
-        std::cout << "The estimate for integral " << P << " is " << globalResult / size << "\n";
+        std::cout << "The estimate for integral " << integrand.name << " is " << globalResult << "\n";
+        if (timing) {
+            double wall = slowest[1] + fastest[2];
+            std::printf("Timing: ranks=%d threads=%d samples=%llu startup=%.6f sampling=%.6f samplingMean=%.6f "
+                        "reduction=%.6f wall=%.6f samplesPerSec=%.6g samplesPerSecPerRank=%.6g\n",
+                        size, numThreads, static_cast<unsigned long long>(N), slowest[0], slowest[1], total[1] / size,
+                        fastest[2], wall, N / wall, N / wall / size);
+            std::fflush(stdout);
+        }
 	 std::cout<<"Bye!"<<std::endl;
     }
 
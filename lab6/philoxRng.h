@@ -0,0 +1,118 @@
+/*
+Author: Kamya Hari
+Course: ECE 6122 A
+Last Date Modified: 10/18/2026
+
+Description:
+Counter-based random numbers for the Monte Carlo integrator. Philox4x32-10 (Salmon et al., SC'11) maps a 128-bit
+counter and a 64-bit key to 128 random bits with no internal state, so any number of independent streams can be
+addressed directly. The key is the user seed; the counter is {position, block, thread, rank}, which gives every
+(rank, thread, block) its own stream of up to 2^33 doubles and makes every draw reproducible from the seed alone.
+*/
+
+#ifndef PHILOX_RNG_H
+#define PHILOX_RNG_H
+
+#include <cstdint>
+
+// One Philox4x32-10 evaluation: out = Philox(counter, key)
+inline void philox4x32(const std::uint32_t counter[4], const std::uint32_t key[2], std::uint32_t out[4]) {
+    const std::uint32_t M0 = 0xD2511F53u, M1 = 0xCD9E8D57u;
+    const std::uint32_t W0 = 0x9E3779B9u, W1 = 0xBB67AE85u;
+    std::uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    std::uint32_t k0 = key[0], k1 = key[1];
+    for (int round = 0; round < 10; ++round) {
+        std::uint64_t p0 = static_cast<std::uint64_t>(M0) * c0;
+        std::uint64_t p1 = static_cast<std::uint64_t>(M1) * c2;
+        std::uint32_t n0 = static_cast<std::uint32_t>(p1 >> 32) ^ c1 ^ k0;
+        std::uint32_t n2 = static_cast<std::uint32_t>(p0 >> 32) ^ c3 ^ k1;
+        c1 = static_cast<std::uint32_t>(p1);
+        c3 = static_cast<std::uint32_t>(p0);
+        c0 = n0;
+        c2 = n2;
+        k0 += W0;
+        k1 += W1;
+    }
+    out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+}
+
+// 53-bit uniform double in [0, 1) from two 32-bit words
+inline double uniformFromBits(std::uint32_t hi, std::uint32_t lo) {
+    return ((hi >> 5) * 67108864.0 + (lo >> 6)) * (1.0 / 9007199254740992.0);
+}
+
+// Stream of uniform doubles for one (rank, thread, block); every Philox call yields two doubles
+class PhiloxStream {
+public:
+    PhiloxStream(std::uint64_t seed, std::uint32_t rank, std::uint32_t thread, std::uint32_t block)
+        : drawn(0) {
+        bits[0] = bits[1] = bits[2] = bits[3] = 0;
+        key[0] = static_cast<std::uint32_t>(seed);
+        key[1] = static_cast<std::uint32_t>(seed >> 32);
+        counter[0] = 0;
+        counter[1] = block;
+        counter[2] = thread;
+        counter[3] = rank;
+    }
+
+    double nextUniform() {
+        if ((drawn & 1) == 0) {
+            counter[0] = static_cast<std::uint32_t>(drawn >> 1);
+            philox4x32(counter, key, bits);
+            ++drawn;
+            return uniformFromBits(bits[0], bits[1]);
+        }
+        ++drawn;
+        return uniformFromBits(bits[2], bits[3]);
+    }
+
+    std::uint64_t position() const { return drawn; }  // doubles drawn so far
+
+    void seek(std::uint64_t position) {  // continue as if 'position' doubles had been drawn
+        drawn = position & ~std::uint64_t(1);
+        if (position & 1) {
+            nextUniform();
+        }
+    }
+
+private:
+    std::uint32_t key[2];
+    std::uint32_t counter[4];
+    std::uint32_t bits[4];
+    std::uint64_t drawn;
+};
+
+// Samples drawn from one stream before moving on to the next block
+const std::uint64_t PHILOX_BLOCK_SAMPLES = std::uint64_t(1) << 32;
+
+// All draws of one (rank, thread): moves on to the next block's stream every PHILOX_BLOCK_SAMPLES doubles, so the
+// first n draws are the same as reading blocks 0, 1, ... one after the other
+class BlockedPhiloxStream {
+public:
+    BlockedPhiloxStream(std::uint64_t seed, std::uint32_t rank, std::uint32_t thread = 0)
+        : seed(seed), rank(rank), thread(thread), drawn(0), stream(seed, rank, thread, 0) {}
+
+    double nextUniform() {
+        if (drawn != 0 && drawn % PHILOX_BLOCK_SAMPLES == 0) {
+            stream = PhiloxStream(seed, rank, thread, static_cast<std::uint32_t>(drawn / PHILOX_BLOCK_SAMPLES));
+        }
+        ++drawn;
+        return stream.nextUniform();
+    }
+
+    std::uint64_t position() const { return drawn; }
+
+    void seek(std::uint64_t position) {  // continue as if 'position' doubles had been drawn
+        drawn = position;
+        stream = PhiloxStream(seed, rank, thread, static_cast<std::uint32_t>(position / PHILOX_BLOCK_SAMPLES));
+        stream.seek(position % PHILOX_BLOCK_SAMPLES);
+    }
+
+private:
+    std::uint64_t seed;
+    std::uint32_t rank, thread;
+    std::uint64_t drawn;
+    PhiloxStream stream;
+};
+
+#endif // PHILOX_RNG_H
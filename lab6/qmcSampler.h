@@ -0,0 +1,236 @@
+/*
+Author: Kamya Hari
+Course: ECE 6122 A
+Last Date Modified: 10/18/2026
+
+Description:
+Quasi-Monte Carlo sampling for -S sobol|halton. SobolSequence is a Gray-code Sobol generator with 64-bit direction
+numbers (Joe & Kuo primitive polynomials, up to QMC_MAX_DIMS dimensions) and a random digital shift; HaltonSequence
+uses the first primes as bases with an independent random permutation of every digit position. Both can jump to any
+index, so rank r takes its own contiguous slice of the point set and the ranks together evaluate exactly the first n
+points with no overlap.
+A single low-discrepancy estimate carries no error estimate, so qmcMonteCarlo repeats the integration with R
+independent scramblings (drawn from Philox streams keyed by the seed) and reports the mean and the standard error of
+the R replicate estimates.
+*/
+
+#ifndef QMC_SAMPLER_H
+#define QMC_SAMPLER_H
+
+#include <mpi.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "philoxRng.h"
+
+const int QMC_MAX_DIMS = 16;
+const int QMC_BITS = 64;
+const std::uint32_t QMC_SCRAMBLE_THREAD = 0x51u;  // Philox thread id of the scrambling streams, apart from sampling
+
+// Scrambling stream of replicate 'replicate'
+inline PhiloxStream qmcScrambleStream(std::uint64_t seed, int replicate) {
+    return PhiloxStream(seed, static_cast<std::uint32_t>(replicate), QMC_SCRAMBLE_THREAD, 0);
+}
+
+class SobolSequence {
+public:
+    // dims <= QMC_MAX_DIMS; replicate selects the digital shift (replicate < 0: unscrambled)
+    SobolSequence(int dims, std::uint64_t seed, int replicate) : dims(dims), index(0) {
+        // Degree s, coefficients a and initial m_1..m_s of dimensions 2..16 (Joe & Kuo, new-joe-kuo-6.21201)
+        static const int degree[QMC_MAX_DIMS] = { 0, 1, 2, 3, 3, 4, 4, 5, 5, 5, 5, 5, 5, 6, 6, 6 };
+        static const int coeff[QMC_MAX_DIMS] = { 0, 0, 1, 1, 2, 1, 4, 2, 4, 7, 11, 13, 14, 1, 13, 16 };
+        static const int initial[QMC_MAX_DIMS][6] = {
+            { 0 }, { 1 }, { 1, 3 }, { 1, 3, 1 }, { 1, 1, 1 }, { 1, 1, 3, 3 }, { 1, 3, 5, 13 }, { 1, 1, 5, 5, 17 },
+            { 1, 1, 5, 5, 5 }, { 1, 1, 7, 11, 19 }, { 1, 1, 5, 1, 1 }, { 1, 1, 1, 3, 11 }, { 1, 3, 5, 5, 31 },
+            { 1, 3, 3, 9, 7, 49 }, { 1, 1, 1, 15, 21, 21 }, { 1, 3, 1, 13, 27, 49 } };
+
+        direction.assign(dims * QMC_BITS, 0);
+        for (int d = 0; d < dims; ++d) {
+            std::uint64_t* v = &direction[d * QMC_BITS];  // v[k - 1] is direction number k
+            if (d == 0) {
+                for (int k = 1; k <= QMC_BITS; ++k) {
+                    v[k - 1] = std::uint64_t(1) << (QMC_BITS - k);
+                }
+                continue;
+            }
+            int s = degree[d];
+            for (int k = 1; k <= s; ++k) {
+                v[k - 1] = static_cast<std::uint64_t>(initial[d][k - 1]) << (QMC_BITS - k);
+            }
+            for (int k = s + 1; k <= QMC_BITS; ++k) {
+                v[k - 1] = v[k - s - 1] ^ (v[k - s - 1] >> s);
+                for (int j = 1; j < s; ++j) {
+                    if ((coeff[d] >> (s - 1 - j)) & 1) {
+                        v[k - 1] ^= v[k - j - 1];
+                    }
+                }
+            }
+        }
+
+        shift.assign(dims, 0);
+        if (replicate >= 0) {
+            PhiloxStream rng = qmcScrambleStream(seed, replicate);
+            for (int d = 0; d < dims; ++d) {
+                shift[d] = static_cast<std::uint64_t>(rng.nextUniform() * 9007199254740992.0) << 11;
+            }
+        }
+        state = shift;
+    }
+
+    // Next call to next() returns point 'position'
+    void seek(std::uint64_t position) {
+        index = position;
+        std::uint64_t gray = position ^ (position >> 1);
+        for (int d = 0; d < dims; ++d) {
+            std::uint64_t x = shift[d];
+            for (int k = 0; k < QMC_BITS; ++k) {
+                if ((gray >> k) & 1) {
+                    x ^= direction[d * QMC_BITS + k];
+                }
+            }
+            state[d] = x;
+        }
+    }
+
+    void next(double* point) {
+        for (int d = 0; d < dims; ++d) {
+            point[d] = (state[d] >> 11) * (1.0 / 9007199254740992.0);
+        }
+        // Gray-code step: flip direction number (lowest zero bit of index) + 1
+        int k = __builtin_ctzll(~index);
+        for (int d = 0; d < dims; ++d) {
+            state[d] ^= direction[d * QMC_BITS + k];
+        }
+        ++index;
+    }
+
+private:
+    int dims;
+    std::uint64_t index;
+    std::vector<std::uint64_t> direction;
+    std::vector<std::uint64_t> shift;
+    std::vector<std::uint64_t> state;
+};
+
+class HaltonSequence {
+public:
+    // dims <= QMC_MAX_DIMS; replicate selects the digit permutations (replicate < 0: unscrambled)
+    HaltonSequence(int dims, std::uint64_t seed, int replicate) : dims(dims), index(0) {
+        static const int primes[QMC_MAX_DIMS] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53 };
+        PhiloxStream rng = qmcScrambleStream(seed, replicate < 0 ? 0 : replicate);
+        for (int d = 0; d < dims; ++d) {
+            Base base;
+            base.base = primes[d];
+            base.digits = static_cast<int>(std::ceil(53.0 / std::log2(static_cast<double>(base.base))));
+            base.permutation.resize(base.digits * base.base);
+            for (int pos = 0; pos < base.digits; ++pos) {
+                int* perm = &base.permutation[pos * base.base];
+                for (int i = 0; i < base.base; ++i) {
+                    perm[i] = i;
+                }
+                if (replicate >= 0) {
+                    for (int i = base.base - 1; i > 0; --i) {  // Fisher-Yates
+                        int j = static_cast<int>(rng.nextUniform() * (i + 1));
+                        std::swap(perm[i], perm[j]);
+                    }
+                }
+            }
+            bases.push_back(base);
+        }
+    }
+
+    void seek(std::uint64_t position) { index = position; }
+
+    // Scrambled radical inverse of the current index in every base; digits beyond the index's length are permuted
+    // zeros, which is what makes the scrambled point uniformly distributed
+    void next(double* point) {
+        for (int d = 0; d < dims; ++d) {
+            const Base& base = bases[d];
+            std::uint64_t rest = index;
+            double scale = 1.0 / base.base, value = 0.0;
+            for (int pos = 0; pos < base.digits; ++pos) {
+                int digit = static_cast<int>(rest % base.base);
+                rest /= base.base;
+                value += base.permutation[pos * base.base + digit] * scale;
+                scale /= base.base;
+            }
+            point[d] = value < 1.0 ? value : 1.0 - 1.0 / 9007199254740992.0;
+        }
+        ++index;
+    }
+
+private:
+    struct Base {
+        int base;
+        int digits;                    // digit positions kept (53 bits of precision)
+        std::vector<int> permutation;  // digits x base: permutation of each digit position
+    };
+    int dims;
+    std::uint64_t index;
+    std::vector<Base> bases;
+};
+
+enum SamplerKind { SAMPLER_RANDOM, SAMPLER_SOBOL, SAMPLER_HALTON };
+
+struct QmcResult {
+    double estimate;   // mean of the replicate estimates
+    double stdError;   // standard error of that mean
+};
+
+// Points [first, first + count) of one scrambled sequence summed through func on [a, b]^Func::dims
+template <typename Func, typename Sequence>
+double qmcSliceSum(Func func, double a, double b, Sequence& sequence, std::uint64_t first, std::uint64_t count) {
+    double sum = 0.0, x[Func::dims];
+    sequence.seek(first);
+    for (std::uint64_t i = 0; i < count; ++i) {
+        sequence.next(x);
+        for (int d = 0; d < Func::dims; ++d) {
+            x[d] = a + (b - a) * x[d];
+        }
+        sum += func(x);
+    }
+    return sum;
+}
+
+// Integrates func on [a, b]^Func::dims with 'replicates' independently scrambled copies of the first
+// pointsPerReplicate points. Every rank evaluates its contiguous slice of each copy; the result is complete on rank 0.
+template <typename Func>
+QmcResult qmcMonteCarlo(Func func, double a, double b, SamplerKind kind, std::uint64_t pointsPerReplicate,
+                        int replicates, std::uint64_t seed, int rank, MPI_Comm comm) {
+    static_assert(Func::dims <= QMC_MAX_DIMS, "QMC sequences support up to QMC_MAX_DIMS dimensions");
+    int size;
+    MPI_Comm_size(comm, &size);
+    std::uint64_t first = pointsPerReplicate / size * rank + std::min<std::uint64_t>(rank, pointsPerReplicate % size);
+    std::uint64_t count = pointsPerReplicate / size + (static_cast<std::uint64_t>(rank) < pointsPerReplicate % size ? 1 : 0);
+
+    std::vector<double> localSums(replicates, 0.0), sums(replicates, 0.0);
+    for (int r = 0; r < replicates; ++r) {
+        if (kind == SAMPLER_SOBOL) {
+            SobolSequence sequence(Func::dims, seed, r);
+            localSums[r] = qmcSliceSum(func, a, b, sequence, first, count);
+        }
+        else {
+            HaltonSequence sequence(Func::dims, seed, r);
+            localSums[r] = qmcSliceSum(func, a, b, sequence, first, count);
+        }
+    }
+    MPI_Reduce(localSums.data(), sums.data(), replicates, MPI_DOUBLE, MPI_SUM, 0, comm);
+
+    QmcResult result = { 0.0, 0.0 };
+    if (rank == 0) {
+        double mean = 0.0, m2 = 0.0;
+        for (int r = 0; r < replicates; ++r) {
+            double estimate = std::pow(b - a, Func::dims) * sums[r] / pointsPerReplicate;
+            double delta = estimate - mean;
+            mean += delta / (r + 1);
+            m2 += delta * (estimate - mean);
+        }
+        result.estimate = mean;
+        result.stdError = replicates > 1 ? std::sqrt(m2 / (replicates - 1) / replicates) : INFINITY;
+    }
+    return result;
+}
+
+#endif // QMC_SAMPLER_H
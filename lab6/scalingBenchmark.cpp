@@ -0,0 +1,273 @@
+/*
+Author: Kamya Hari
+Course: ECE 6122 A
+Last Date Modified: 10/18/2026
+
+Description:
+Strong and weak scaling benchmark for lab6. For every rank count in --ranks, it launches
+"<launcher> -np <k> <binary> -P <integrand> -N <samples> --timing" through popen and reads the "Timing:" line that lab6
+prints. That line gives the startup, sampling and reduction time of the run. The time mpirun itself takes
+(process launch and MPI_Finalize) is the wall time of the launch minus those phases.
+Strong scaling keeps N fixed, so the efficiency is T(k0) * k0 / (T(k) * k). Weak scaling runs N samples per rank, so
+the efficiency is T(k0) / T(k). k0 is the smallest rank count, and T is the sampling plus reduction time of the best
+of --repeat runs. The results go to a table on stdout and to a JSON report (--json), so runs on different hardware or
+with different MPI settings can be compared.
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+std::string binary = "./lab6"; //lab6 executable (--binary)
+std::string launcher = "mpirun"; //MPI launcher and its options, -np <k> is appended (--launcher)
+std::string integrandName = "2"; //integrand passed to -P
+double N = 1e8; //samples in total (strong) or per rank (weak)
+int numThreads = -1; //-T for lab6 (-1: scalar sampler)
+std::vector<int> rankCounts = { 1, 2, 4 }; //rank counts to sweep (--ranks)
+bool strongMode = true, weakMode = true; //--mode strong|weak|both
+int repeats = 3; //runs per configuration, the fastest is kept (--repeat)
+const char* jsonFile = "scaling.json"; //JSON report (--json)
+
+//One measured launch of lab6
+struct ScalingRun {
+    const char* mode;
+    int ranks;
+    unsigned long long samples;
+    double estimate;
+    double launch;        // mpirun overhead: launch wall time minus the phases below
+    double startup;       // process start to the end of argument parsing, slowest rank
+    double sampling;      // slowest rank
+    double samplingMean;
+    double reduction;
+    double wall;          // sampling + reduction
+    double samplesPerSec;
+    double speedup;
+    double efficiency;
+};
+
+//Reads "key=value" from a Timing line; false if the key is missing
+bool timingValue(const std::string& line, const char* key, double& value) {
+    std::string pattern = std::string(" ") + key + "=";
+    size_t position = line.find(pattern);
+    if (position == std::string::npos) {
+        return false;
+    }
+    value = atof(line.c_str() + position + pattern.size());
+    return true;
+}
+
+//Launches lab6 once on 'ranks' ranks with 'samples' samples; false (with the output printed) if it fails
+bool launch(int ranks, unsigned long long samples, ScalingRun& run) {
+    std::string command = launcher + " -np " + std::to_string(ranks) + " " + binary + " -P " + integrandName
+                          + " -N " + std::to_string(samples) + " --timing";
+    if (numThreads >= 0) {
+        command += " -T " + std::to_string(numThreads);
+    }
+    command += " 2>&1";
+
+    auto start = std::chrono::steady_clock::now();
+    FILE* pipe = popen(command.c_str(), "r");
+    if (pipe == nullptr) {
+        std::cerr << "Cannot run " << command << "\n";
+        return false;
+    }
+    std::string output, timingLine;
+    char buffer[4096];
+    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
+        output += buffer;
+        if (strncmp(buffer, "Timing:", 7) == 0) {
+            timingLine = buffer;
+        }
+    }
+    int status = pclose(pipe);
+    double launchWall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const char* estimateLabel = " is ";
+    size_t estimatePosition = output.find("The estimate for integral");
+    if (status != 0 || timingLine.empty() || estimatePosition == std::string::npos) {
+        std::cerr << "Failed: " << command << "\n" << output;
+        return false;
+    }
+    run.estimate = atof(output.c_str() + output.find(estimateLabel, estimatePosition) + strlen(estimateLabel));
+    run.ranks = ranks;
+    run.samples = samples;
+    bool complete = timingValue(timingLine, "startup", run.startup) && timingValue(timingLine, "sampling", run.sampling)
+                    && timingValue(timingLine, "samplingMean", run.samplingMean)
+                    && timingValue(timingLine, "reduction", run.reduction) && timingValue(timingLine, "wall", run.wall);
+    if (!complete || run.wall <= 0.0) {
+        std::cerr << "Malformed timing line: " << timingLine;
+        return false;
+    }
+    run.samplesPerSec = samples / run.wall;
+    run.launch = launchWall - run.startup - run.wall;
+    return true;
+}
+
+//Parses a comma-separated list of positive rank counts
+bool parseRankCounts(const char* text, std::vector<int>& counts) {
+    counts.clear();
+    while (*text != '\0') {
+        char* end;
+        long count = strtol(text, &end, 10);
+        if (end == text || count < 1 || (*end != ',' && *end != '\0')) {
+            return false;
+        }
+        counts.push_back(static_cast<int>(count));
+        text = (*end == ',') ? end + 1 : end;
+    }
+    return !counts.empty();
+}
+
+bool parseArguments(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--binary") == 0 && i + 1 < argc) {
+            binary = argv[++i];
+        }
+        else if (strcmp(argv[i], "--launcher") == 0 && i + 1 < argc) {
+            launcher = argv[++i];
+        }
+        else if (strcmp(argv[i], "-P") == 0 && i + 1 < argc) {
+            integrandName = argv[++i];
+        }
+        else if (strcmp(argv[i], "-N") == 0 && i + 1 < argc) {
+            N = atof(argv[++i]);
+            if (N < 1.0 || N > 1e15) {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], "-T") == 0 && i + 1 < argc) {
+            numThreads = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--ranks") == 0 && i + 1 < argc) {
+            if (!parseRankCounts(argv[++i], rankCounts)) {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc) {
+            ++i;
+            strongMode = strcmp(argv[i], "strong") == 0 || strcmp(argv[i], "both") == 0;
+            weakMode = strcmp(argv[i], "weak") == 0 || strcmp(argv[i], "both") == 0;
+            if (!strongMode && !weakMode) {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeats = atoi(argv[++i]);
+            if (repeats < 1) {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonFile = argv[++i];
+        }
+        else {
+            return false;
+        }
+    }
+    return true;
+}
+
+//Writes a string as a JSON string literal
+void writeJsonString(FILE* out, const std::string& text) {
+    std::fputc('"', out);
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            std::fputc('\\', out);
+        }
+        std::fputc(c, out);
+    }
+    std::fputc('"', out);
+}
+
+bool writeJson(const std::vector<ScalingRun>& runs) {
+    FILE* out = std::fopen(jsonFile, "w");
+    if (out == nullptr) {
+        return false;
+    }
+    std::fprintf(out, "{\n  \"binary\": ");
+    writeJsonString(out, binary);
+    std::fprintf(out, ",\n  \"launcher\": ");
+    writeJsonString(out, launcher);
+    std::fprintf(out, ",\n  \"integrand\": ");
+    writeJsonString(out, integrandName);
+    std::fprintf(out, ",\n  \"threadsPerRank\": %d,\n  \"hardwareThreads\": %u,\n  \"repeat\": %d,\n  \"runs\": [",
+                 numThreads, std::thread::hardware_concurrency(), repeats);
+    for (size_t i = 0; i < runs.size(); ++i) {
+        const ScalingRun& run = runs[i];
+        std::fprintf(out,
+                     "%s\n    {\"mode\": \"%s\", \"ranks\": %d, \"samples\": %llu, \"estimate\": %.17g, "
+                     "\"launchSeconds\": %.6f, \"startupSeconds\": %.6f, \"samplingSeconds\": %.6f, "
+                     "\"samplingMeanSeconds\": %.6f, \"reductionSeconds\": %.6f, \"wallSeconds\": %.6f, "
+                     "\"samplesPerSec\": %.6g, \"samplesPerSecPerRank\": %.6g, \"speedup\": %.4f, \"efficiency\": %.4f}",
+                     i == 0 ? "" : ",", run.mode, run.ranks, run.samples, run.estimate, run.launch, run.startup,
+                     run.sampling, run.samplingMean, run.reduction, run.wall, run.samplesPerSec,
+                     run.samplesPerSec / run.ranks, run.speedup, run.efficiency);
+    }
+    std::fprintf(out, "\n  ]\n}\n");
+    return std::fclose(out) == 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (!parseArguments(argc, argv)) {
+        std::cerr << "Usage: " << argv[0] << " [-P <integrand>] [-N <samples>] [-T <threads>] [--ranks <k1,k2,...>]"
+                  << " [--mode strong|weak|both] [--repeat <r>] [--launcher \"<mpirun and options>\"]"
+                  << " [--binary <lab6>] [--json <file>]\n"
+                  << "N is the total sample count for strong scaling and the count per rank for weak scaling.\n";
+        return 1;
+    }
+
+    std::vector<ScalingRun> runs;
+    std::printf("mode    ranks        samples   wall(s) sampling(s) imbalance reduce(s) startup(s) launch(s)"
+                "     samples/s  per rank  speedup  efficiency\n");
+    for (int weak = 0; weak < 2; ++weak) {
+        if (weak ? !weakMode : !strongMode) {
+            continue;
+        }
+        size_t first = runs.size();
+        for (size_t c = 0; c < rankCounts.size(); ++c) {
+            int ranks = rankCounts[c];
+            unsigned long long samples = static_cast<unsigned long long>(weak ? N * ranks : N);
+            ScalingRun best;
+            for (int r = 0; r < repeats; ++r) {
+                ScalingRun run;
+                if (!launch(ranks, samples, run)) {
+                    return 1;
+                }
+                if (r == 0 || run.wall < best.wall) {
+                    best = run;
+                }
+            }
+            best.mode = weak ? "weak" : "strong";
+            runs.push_back(best);
+        }
+        // Speedup and efficiency against the smallest rank count of this mode
+        size_t base = first;
+        for (size_t i = first; i < runs.size(); ++i) {
+            if (runs[i].ranks < runs[base].ranks) {
+                base = i;
+            }
+        }
+        for (size_t i = first; i < runs.size(); ++i) {
+            ScalingRun& run = runs[i];
+            run.speedup = weak ? run.samplesPerSec / runs[base].samplesPerSec : runs[base].wall / run.wall;
+            run.efficiency = run.speedup * runs[base].ranks / run.ranks;
+            std::printf("%-6s %6d %14llu %9.4f %11.4f %8.1f%% %9.5f %10.4f %9.4f %13.4g %9.4g %8.2f %10.1f%%\n",
+                        run.mode, run.ranks, run.samples, run.wall, run.sampling,
+                        run.sampling > 0.0 ? 100.0 * (run.sampling - run.samplingMean) / run.sampling : 0.0,
+                        run.reduction, run.startup, run.launch, run.samplesPerSec, run.samplesPerSec / run.ranks,
+                        run.speedup, 100.0 * run.efficiency);
+        }
+    }
+
+    if (!writeJson(runs)) {
+        std::cerr << "Cannot write " << jsonFile << "\n";
+        return 1;
+    }
+    std::cout << "Report written to " << jsonFile << std::endl;
+    return 0;
+}
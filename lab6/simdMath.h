@@ -0,0 +1,56 @@
+/*
+Author: Kamya Hari
+Course: ECE 6122 A
+Last Date Modified: 10/18/2026
+
+Description:
+Branch-free exp() that the compiler can vectorize inside "omp simd" loops, used by the hybrid Monte Carlo kernel.
+x = k ln2 + r with |r| <= ln2/2; e^r is a degree-12 Taylor polynomial; the result is within about 3e-16 relative of std::exp
+and 2^k is built directly in the exponent bits. Inputs are clamped to [-708, 708].
+*/
+
+#ifndef SIMD_MATH_H
+#define SIMD_MATH_H
+
+#include <cstdint>
+#include <cstring>
+
+#ifdef _OPENMP
+#pragma omp declare simd notinbranch
+#endif
+inline double simdExp(double x) {
+    const double LOG2E = 1.4426950408889634;
+    const double LN2_HI = 6.93147180369123816490e-01;  // ln2 split so k * LN2_HI is exact
+    const double LN2_LO = 1.90821492927058770002e-10;
+    const double ROUNDER = 6755399441055744.0;         // 1.5 * 2^52: adding it rounds to an integer in the low bits
+
+    x = x < -708.0 ? -708.0 : (x > 708.0 ? 708.0 : x);
+    double shifted = x * LOG2E + ROUNDER;
+    double k = shifted - ROUNDER;
+    double r = (x - k * LN2_HI) - k * LN2_LO;
+
+    double p = 1.0 / 479001600.0;
+    p = p * r + 1.0 / 39916800.0;
+    p = p * r + 1.0 / 3628800.0;
+    p = p * r + 1.0 / 362880.0;
+    p = p * r + 1.0 / 40320.0;
+    p = p * r + 1.0 / 5040.0;
+    p = p * r + 1.0 / 720.0;
+    p = p * r + 1.0 / 120.0;
+    p = p * r + 1.0 / 24.0;
+    p = p * r + 1.0 / 6.0;
+    p = p * r + 0.5;
+    p = p * r + 1.0;
+    p = p * r + 1.0;
+
+    std::uint64_t bits;
+    std::memcpy(&bits, &shifted, sizeof(bits));
+    // The low bits of 'shifted' hold k; move k + 1023 into the exponent. Unsigned, so the bits shifted out are simply
+    // dropped (a signed shift into the sign bit would be undefined).
+    std::uint64_t scaleBits = (bits + 1023) << 52;
+    double scale;
+    std::memcpy(&scale, &scaleBits, sizeof(scale));
+    return p * scale;
+}
+
+#endif // SIMD_MATH_H
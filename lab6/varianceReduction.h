@@ -0,0 +1,252 @@
+/*
+Author: Kamya Hari
+Course: ECE 6122 A
+Last Date Modified: 10/18/2026
+
+Description:
+Variance-reduced Monte Carlo. The integral is written over u in [0, 1]: a proposal density q maps u to x in [a, b]
+by its inverse CDF and every sample contributes h(u) = (b - a) f(x) / q. On top of that importance sampling the
+following options compose freely:
+  stratified  - [0, 1] is cut into K strata and every stratum gets the same number of samples,
+  antithetic  - every u is paired with its mirror image inside its stratum and the pair average is one unit,
+  control     - the unit is corrected by beta * (c - E[c]) with the control c = u^2, whose stratum means are known
+                exactly; beta is the pooled least-squares slope.
+Every rank samples all strata from its own Philox stream and keeps per-stratum running statistics, which are merged
+across ranks with Chan's formula. From those statistics the run also computes, per sample, the variance that plain
+uniform sampling and each intermediate stage would have had, so every option reports its own variance reduction
+factor (VRF) measured against the stage before it.
+*/
+
+#ifndef VARIANCE_REDUCTION_H
+#define VARIANCE_REDUCTION_H
+
+#include <mpi.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "philoxRng.h"
+#include "adaptiveSampler.h"
+
+enum ProposalKind { PROPOSAL_UNIFORM, PROPOSAL_LINEAR, PROPOSAL_EXP };
+
+// Importance-sampling proposal on [a, b], in terms of t = (x - a) / (b - a):
+// linear q(t) = (1 + s t) / (1 + s / 2) with s > -1, exp q(t) = lambda e^(-lambda t) / (1 - e^(-lambda)) with lambda != 0
+struct Proposal {
+    ProposalKind kind;
+    double param;
+
+    // Maps u to t and returns q(t)
+    double sample(double u, double& t) const {
+        switch (kind) {
+        case PROPOSAL_LINEAR:
+            if (param != 0.0) {
+                t = (std::sqrt(1.0 + 2.0 * param * u * (1.0 + 0.5 * param)) - 1.0) / param;
+                return (1.0 + param * t) / (1.0 + 0.5 * param);
+            }
+            break;
+        case PROPOSAL_EXP:
+            t = -std::log1p(u * std::expm1(-param)) / param;
+            return param * std::exp(-param * t) / -std::expm1(-param);
+        default:
+            break;
+        }
+        t = u;
+        return 1.0;
+    }
+};
+
+// Parses "uniform", "linear:<s>" or "exp:<lambda>"; returns false if the text or parameter is invalid
+inline bool parseProposal(const char* text, Proposal& proposal) {
+    if (std::strcmp(text, "uniform") == 0) {
+        proposal.kind = PROPOSAL_UNIFORM;
+        proposal.param = 0.0;
+        return true;
+    }
+    if (std::strncmp(text, "linear:", 7) == 0) {
+        proposal.kind = PROPOSAL_LINEAR;
+        proposal.param = std::atof(text + 7);
+        return proposal.param > -1.0;
+    }
+    if (std::strncmp(text, "exp:", 4) == 0) {
+        proposal.kind = PROPOSAL_EXP;
+        proposal.param = std::atof(text + 4);
+        return proposal.param != 0.0;
+    }
+    return false;
+}
+
+// Running means, sums of squared deviations and co-deviation of (unit, control) pairs
+struct PairStats {
+    double count;
+    double meanY, meanC;
+    double m2Y, m2C, coYC;
+};
+
+inline void addPair(PairStats& stats, double y, double c) {
+    stats.count += 1.0;
+    double dy = y - stats.meanY;
+    double dc = c - stats.meanC;
+    stats.meanY += dy / stats.count;
+    stats.meanC += dc / stats.count;
+    stats.m2Y += dy * (y - stats.meanY);
+    stats.m2C += dc * (c - stats.meanC);
+    stats.coYC += dy * (c - stats.meanC);
+}
+
+inline void mergePair(PairStats& into, const PairStats& other) {
+    if (other.count == 0.0) {
+        return;
+    }
+    double count = into.count + other.count;
+    double dy = other.meanY - into.meanY;
+    double dc = other.meanC - into.meanC;
+    double weight = into.count * other.count / count;
+    into.meanY += dy * (other.count / count);
+    into.meanC += dc * (other.count / count);
+    into.m2Y += other.m2Y + dy * dy * weight;
+    into.m2C += other.m2C + dc * dc * weight;
+    into.coYC += other.coYC + dy * dc * weight;
+    into.count = count;
+}
+
+// Everything kept per stratum: single evaluations h, the plain-sampling second moment term, and the units
+struct StratumStats {
+    RunningStats single;
+    RunningStats plain;
+    PairStats unit;
+};
+
+inline void mergeStratumOp(void* in, void* inout, int* len, MPI_Datatype*) {
+    const StratumStats* src = static_cast<const StratumStats*>(in);
+    StratumStats* dst = static_cast<StratumStats*>(inout);
+    for (int i = 0; i < *len; ++i) {
+        mergeStats(dst[i].single, src[i].single);
+        mergeStats(dst[i].plain, src[i].plain);
+        mergePair(dst[i].unit, src[i].unit);
+    }
+}
+
+struct VarianceReductionOptions {
+    int strata;          // 1: no stratification
+    bool antithetic;
+    bool controlVariate;
+    Proposal proposal;
+};
+
+struct VarianceReductionResult {
+    double estimate;
+    double stdError;
+    double evaluations;      // integrand evaluations by all ranks
+    double plainVariance;    // per-evaluation variance of plain uniform sampling
+    double isVariance;       // ... with the proposal
+    double strataVariance;   // ... with the proposal and stratification
+    double antitheticVariance;
+    double finalVariance;    // ... with every selected option
+};
+
+// Integrates the one-dimensional func on [a, b] with the selected options from numSamples evaluations in total (per
+// rank: the rank's share, spread evenly over the strata). The result is complete on every rank.
+template <typename Func>
+VarianceReductionResult varianceReducedMonteCarlo(Func func, double a, double b, const VarianceReductionOptions& options,
+                                                  std::uint64_t numSamples, std::uint64_t seed, int rank, MPI_Comm comm) {
+    static_assert(Func::dims == 1, "variance reduction is defined for one-dimensional integrands");
+    int size;
+    MPI_Comm_size(comm, &size);
+    const int K = options.strata;
+    const int cost = options.antithetic ? 2 : 1;
+    const double width = b - a;
+    std::uint64_t unitsPerStratum = numSamples / (static_cast<std::uint64_t>(size) * K * cost);
+    if (unitsPerStratum < 2) {
+        unitsPerStratum = 2;
+    }
+
+    std::vector<StratumStats> local(K), global(K);
+    for (StratumStats& s : local) {
+        s.single = { 0.0, 0.0, 0.0 };
+        s.plain = { 0.0, 0.0, 0.0 };
+        s.unit = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+    }
+
+    BlockedPhiloxStream rng(seed, rank);
+    // h(u) for one point; also records it as a single evaluation of the stratum
+    auto evaluate = [&](StratumStats& s, double u) {
+        double t;
+        double q = options.proposal.sample(u, t);
+        double x = a + width * t;
+        double fx = func(&x);
+        double h = width * fx / q;
+        addSample(s.single, h);
+        addSample(s.plain, width * width * fx * fx / q);  // E_q[((b - a) f)^2 / q] is the plain second moment
+        return h;
+    };
+
+    for (int j = 0; j < K; ++j) {
+        StratumStats& s = local[j];
+        for (std::uint64_t i = 0; i < unitsPerStratum; ++i) {
+            double v = rng.nextUniform();
+            double u = (j + v) / K;
+            double y = evaluate(s, u);
+            double c = u * u;
+            if (options.antithetic) {
+                double mirror = (j + 1.0 - v) / K;
+                y = 0.5 * (y + evaluate(s, mirror));
+                c = 0.5 * (c + mirror * mirror);
+            }
+            addPair(s.unit, y, c);
+        }
+    }
+
+    MPI_Datatype statsType;
+    MPI_Type_contiguous(static_cast<int>(sizeof(StratumStats) / sizeof(double)), MPI_DOUBLE, &statsType);
+    MPI_Type_commit(&statsType);
+    MPI_Op mergeOp;
+    MPI_Op_create(mergeStratumOp, 1, &mergeOp);
+    MPI_Allreduce(local.data(), global.data(), K, statsType, mergeOp, comm);
+    MPI_Op_free(&mergeOp);
+    MPI_Type_free(&statsType);
+
+    // Pooled control-variate slope from the within-stratum (co)variances
+    double beta = 0.0;
+    if (options.controlVariate) {
+        double co = 0.0, varC = 0.0;
+        for (const StratumStats& s : global) {
+            co += s.unit.coYC;
+            varC += s.unit.m2C;
+        }
+        beta = varC > 0.0 ? co / varC : 0.0;
+    }
+
+    VarianceReductionResult result;
+    RunningStats pooled = { 0.0, 0.0, 0.0 }, plain = { 0.0, 0.0, 0.0 };
+    double estimate = 0.0, estimatorVariance = 0.0;
+    double strataVariance = 0.0, unitVariance = 0.0, residualVariance = 0.0;
+    for (int j = 0; j < K; ++j) {
+        const StratumStats& s = global[j];
+        double n = s.unit.count;
+        // E[u^2] over stratum j
+        double controlMean = (3.0 * j * j + 3.0 * j + 1.0) / (3.0 * K * K);
+        estimate += (s.unit.meanY - beta * (s.unit.meanC - controlMean)) / K;
+        double residual = std::max(0.0, s.unit.m2Y - 2.0 * beta * s.unit.coYC + beta * beta * s.unit.m2C) / (n - 1.0);
+        estimatorVariance += residual / n / (static_cast<double>(K) * K);
+        strataVariance += s.single.m2 / (s.single.count - 1.0) / K;
+        unitVariance += s.unit.m2Y / (n - 1.0) / K;
+        residualVariance += residual / K;
+        mergeStats(pooled, s.single);
+        mergeStats(plain, s.plain);
+    }
+
+    result.estimate = estimate;
+    result.stdError = std::sqrt(estimatorVariance);
+    result.evaluations = pooled.count;
+    result.plainVariance = plain.mean - estimate * estimate;
+    result.isVariance = pooled.m2 / (pooled.count - 1.0);
+    result.strataVariance = strataVariance;
+    result.antitheticVariance = cost * unitVariance;
+    result.finalVariance = cost * residualVariance;
+    return result;
+}
+
+#endif // VARIANCE_REDUCTION_H
@@ -0,0 +1,297 @@
+/*
+Author: Kamya Hari
+Course: ECE 6122 A
+Last Date Modified: 10/18/2026
+
+Description:
+Adaptive d-dimensional integration over MPI for -M vegas|miser.
+VEGAS (Lepage) keeps a separable grid of VEGAS_BINS bins per axis and samples each axis through it, which is
+importance sampling with a product density. Each iteration every rank draws its share of the calls through the
+current grid and accumulates f^2 per bin and axis. The accumulators are summed with one MPI_Allreduce, and every
+rank then refines the grid from the same totals, so the grids stay identical without sending them. The per-iteration
+estimates are combined weighted by their inverse variances, and chi^2 / dof checks that the iterations agree.
+MISER (Press & Farrar) bisects the region recursively. Each split is chosen from a small presample, along the axis
+whose two halves have the smallest combined spread, and the remaining calls go to the halves in proportion to
+their spread. All ranks draw their share of every presample and leaf; the presample statistics are summed before
+each split, so every rank builds the same tree, and the leaf sums are reduced once at the end.
+*/
+
+#ifndef VEGAS_MISER_H
+#define VEGAS_MISER_H
+
+#include <mpi.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "philoxRng.h"
+
+const int VEGAS_BINS = 50;
+const double VEGAS_ALPHA = 1.5;      // grid stiffness: 0 keeps the grid, larger values adapt faster
+const double MISER_PRESAMPLE = 0.1;  // fraction of a region's calls spent choosing its split
+const double MISER_EXPONENT = 2.0 / 3.0;  // sigma^(2 / (1 + alpha)) with the usual alpha = 2
+
+enum AdaptiveMethod { METHOD_NONE, METHOD_VEGAS, METHOD_MISER };
+
+struct MultiDimResult {
+    double estimate;
+    double stdError;
+    double chi2PerDof;   // VEGAS only: consistency of the iterations (about 1 when they agree)
+    double calls;        // integrand evaluations by all ranks
+};
+
+// Calls of 'rank' when 'total' calls are split over 'size' ranks
+inline std::uint64_t rankShare(std::uint64_t total, int size, int rank) {
+    return total / size + (static_cast<std::uint64_t>(rank) < total % size ? 1 : 0);
+}
+
+// Moves the bin edges of one axis so that every new bin carries the same share of the smoothed, damped f^2
+inline void refineVegasAxis(double* edges, const double* binSquares) {
+    double smoothed[VEGAS_BINS], weight[VEGAS_BINS];
+    double total = 0.0;
+    for (int i = 0; i < VEGAS_BINS; ++i) {
+        double left = binSquares[std::max(i - 1, 0)], right = binSquares[std::min(i + 1, VEGAS_BINS - 1)];
+        int count = 1 + (i > 0) + (i < VEGAS_BINS - 1);
+        smoothed[i] = (binSquares[i] + (i > 0 ? left : 0.0) + (i < VEGAS_BINS - 1 ? right : 0.0)) / count;
+        total += smoothed[i];
+    }
+    if (!(total > 0.0)) {
+        return;
+    }
+    double weightSum = 0.0;
+    for (int i = 0; i < VEGAS_BINS; ++i) {
+        double r = smoothed[i] / total;
+        weight[i] = (r > 0.0 && r < 1.0) ? std::pow((r - 1.0) / std::log(r), VEGAS_ALPHA) : (r >= 1.0 ? 1.0 : 0.0);
+        weightSum += weight[i];
+    }
+    double target = weightSum / VEGAS_BINS;
+    double newEdges[VEGAS_BINS + 1];
+    newEdges[0] = 0.0;
+    newEdges[VEGAS_BINS] = 1.0;
+    int bin = 0;
+    double accumulated = 0.0;
+    for (int k = 1; k < VEGAS_BINS; ++k) {
+        double goal = k * target;
+        while (bin < VEGAS_BINS - 1 && accumulated + weight[bin] < goal) {
+            accumulated += weight[bin];
+            ++bin;
+        }
+        double fraction = weight[bin] > 0.0 ? std::min(1.0, (goal - accumulated) / weight[bin]) : 0.0;
+        newEdges[k] = edges[bin] + fraction * (edges[bin + 1] - edges[bin]);
+    }
+    std::copy(newEdges, newEdges + VEGAS_BINS + 1, edges);
+}
+
+// VEGAS on [a, b]^Func::dims: 'iterations' iterations of callsPerIteration calls each. Complete on every rank.
+template <typename Func>
+MultiDimResult vegasIntegrate(Func func, double a, double b, int iterations, std::uint64_t callsPerIteration,
+                              std::uint64_t seed, int rank, MPI_Comm comm) {
+    const int dims = Func::dims;
+    int size;
+    MPI_Comm_size(comm, &size);
+    const double volume = std::pow(b - a, dims);
+
+    std::vector<double> edges(dims * (VEGAS_BINS + 1));
+    for (int d = 0; d < dims; ++d) {
+        for (int i = 0; i <= VEGAS_BINS; ++i) {
+            edges[d * (VEGAS_BINS + 1) + i] = static_cast<double>(i) / VEGAS_BINS;
+        }
+    }
+
+    BlockedPhiloxStream rng(seed, rank);
+    const std::uint64_t localCalls = rankShare(callsPerIteration, size, rank);
+    // Layout of the reduced buffer: sum of f, sum of f^2, then f^2 per (axis, bin)
+    std::vector<double> local(2 + dims * VEGAS_BINS), global(local.size());
+    double weightedSum = 0.0, weightTotal = 0.0, chi2Sum = 0.0, estimateSquares = 0.0;
+    int bins[dims];
+    double x[dims];
+
+    for (int it = 0; it < iterations; ++it) {
+        std::fill(local.begin(), local.end(), 0.0);
+        for (std::uint64_t i = 0; i < localCalls; ++i) {
+            double jacobian = volume;
+            for (int d = 0; d < dims; ++d) {
+                double y = rng.nextUniform() * VEGAS_BINS;
+                int bin = std::min(static_cast<int>(y), VEGAS_BINS - 1);
+                const double* e = &edges[d * (VEGAS_BINS + 1)];
+                double width = e[bin + 1] - e[bin];
+                x[d] = a + (b - a) * (e[bin] + (y - bin) * width);
+                jacobian *= VEGAS_BINS * width;
+                bins[d] = bin;
+            }
+            double value = func(x) * jacobian;
+            double square = value * value;
+            local[0] += value;
+            local[1] += square;
+            for (int d = 0; d < dims; ++d) {
+                local[2 + d * VEGAS_BINS + bins[d]] += square;
+            }
+        }
+        MPI_Allreduce(local.data(), global.data(), static_cast<int>(local.size()), MPI_DOUBLE, MPI_SUM, comm);
+
+        double n = static_cast<double>(callsPerIteration);
+        double mean = global[0] / n;
+        double variance = std::max((global[1] / n - mean * mean) / (n - 1.0), 1e-300);
+        weightedSum += mean / variance;
+        weightTotal += 1.0 / variance;
+        estimateSquares += mean * mean / variance;
+        chi2Sum = estimateSquares - weightedSum * weightedSum / weightTotal;
+
+        for (int d = 0; d < dims; ++d) {
+            refineVegasAxis(&edges[d * (VEGAS_BINS + 1)], &global[2 + d * VEGAS_BINS]);
+        }
+    }
+
+    MultiDimResult result;
+    result.estimate = weightedSum / weightTotal;
+    result.stdError = std::sqrt(1.0 / weightTotal);
+    result.chi2PerDof = iterations > 1 ? chi2Sum / (iterations - 1) : 0.0;
+    result.calls = static_cast<double>(callsPerIteration) * iterations;
+    return result;
+}
+
+// State of one MISER run: the rank's stream and, per leaf in tree order, this rank's (sum, sum of squares, count)
+template <typename Func>
+struct MiserRun {
+    Func func;
+    double a, b;
+    int rank, size;
+    MPI_Comm comm;
+    BlockedPhiloxStream rng;
+    std::uint64_t minLeaf, minBisection;
+    std::vector<double> leafSums;    // 3 per leaf
+    std::vector<double> leafVolumes;
+    double presampleCalls;
+
+    MiserRun(Func func, double a, double b, std::uint64_t seed, int rank, int size, MPI_Comm comm)
+        : func(func), a(a), b(b), rank(rank), size(size), comm(comm), rng(seed, rank),
+          minLeaf(16 * Func::dims), minBisection(32 * 16 * Func::dims), presampleCalls(0.0) {}
+
+    // f at a uniform point of the box [lower, upper] (unit-cube coordinates); the point is left in t
+    double samplePoint(const double* lower, const double* upper, double* t) {
+        double x[Func::dims];
+        for (int d = 0; d < Func::dims; ++d) {
+            t[d] = lower[d] + (upper[d] - lower[d]) * rng.nextUniform();
+            x[d] = a + (b - a) * t[d];
+        }
+        return func(x);
+    }
+
+    void region(double* lower, double* upper, std::uint64_t calls) {
+        const int dims = Func::dims;
+        double volume = 1.0;
+        for (int d = 0; d < dims; ++d) {
+            volume *= upper[d] - lower[d];
+        }
+
+        if (calls < minBisection) {
+            double sum = 0.0, squares = 0.0, t[Func::dims];
+            std::uint64_t mine = rankShare(calls, size, rank);
+            for (std::uint64_t i = 0; i < mine; ++i) {
+                double value = samplePoint(lower, upper, t);
+                sum += value;
+                squares += value * value;
+            }
+            leafSums.push_back(sum);
+            leafSums.push_back(squares);
+            leafSums.push_back(static_cast<double>(mine));
+            leafVolumes.push_back(volume);
+            return;
+        }
+
+        // Presample: (count, sum, sum of squares) of the lower and upper half of every axis
+        std::uint64_t presample = std::max<std::uint64_t>(static_cast<std::uint64_t>(calls * MISER_PRESAMPLE), minLeaf);
+        std::vector<double> local(dims * 6, 0.0), global(dims * 6);
+        double t[Func::dims];
+        std::uint64_t mine = rankShare(presample, size, rank);
+        for (std::uint64_t i = 0; i < mine; ++i) {
+            double value = samplePoint(lower, upper, t);
+            for (int d = 0; d < dims; ++d) {
+                int side = t[d] < 0.5 * (lower[d] + upper[d]) ? 0 : 1;
+                double* s = &local[d * 6 + side * 3];
+                s[0] += 1.0;
+                s[1] += value;
+                s[2] += value * value;
+            }
+        }
+        MPI_Allreduce(local.data(), global.data(), dims * 6, MPI_DOUBLE, MPI_SUM, comm);
+        presampleCalls += static_cast<double>(presample);
+
+        // Axis whose halves have the smallest sigma_l^beta + sigma_r^beta
+        int bestAxis = -1;
+        double bestScore = INFINITY, bestLeft = 0.0, bestRight = 0.0;
+        for (int d = 0; d < dims; ++d) {
+            const double* left = &global[d * 6];
+            const double* right = &global[d * 6 + 3];
+            if (left[0] < 2.0 || right[0] < 2.0) {
+                continue;
+            }
+            double sigmaLeft = std::sqrt(std::max(0.0, left[2] / left[0] - (left[1] / left[0]) * (left[1] / left[0])));
+            double sigmaRight = std::sqrt(std::max(0.0, right[2] / right[0] - (right[1] / right[0]) * (right[1] / right[0])));
+            double l = std::pow(sigmaLeft, MISER_EXPONENT), r = std::pow(sigmaRight, MISER_EXPONENT);
+            if (l + r < bestScore) {
+                bestScore = l + r;
+                bestAxis = d;
+                bestLeft = l;
+                bestRight = r;
+            }
+        }
+
+        std::uint64_t remaining = calls - presample;
+        if (bestAxis < 0) {
+            region(lower, upper, std::min<std::uint64_t>(remaining, minBisection - 1));  // no usable split: sample as a leaf
+            return;
+        }
+        double fraction = (bestLeft + bestRight) > 0.0 ? bestLeft / (bestLeft + bestRight) : 0.5;
+        std::uint64_t leftCalls = std::max(minLeaf, static_cast<std::uint64_t>(remaining * fraction));
+        std::uint64_t rightCalls = std::max(minLeaf, remaining > leftCalls ? remaining - leftCalls : 0);
+
+        double middle = 0.5 * (lower[bestAxis] + upper[bestAxis]);
+        double saved = upper[bestAxis];
+        upper[bestAxis] = middle;
+        region(lower, upper, leftCalls);
+        upper[bestAxis] = saved;
+        saved = lower[bestAxis];
+        lower[bestAxis] = middle;
+        region(lower, upper, rightCalls);
+        lower[bestAxis] = saved;
+    }
+};
+
+// MISER on [a, b]^Func::dims with about 'calls' evaluations in total. Complete on every rank.
+template <typename Func>
+MultiDimResult miserIntegrate(Func func, double a, double b, std::uint64_t calls, std::uint64_t seed, int rank, MPI_Comm comm) {
+    int size;
+    MPI_Comm_size(comm, &size);
+    MiserRun<Func> run(func, a, b, seed, rank, size, comm);
+    double lower[Func::dims], upper[Func::dims];
+    for (int d = 0; d < Func::dims; ++d) {
+        lower[d] = 0.0;
+        upper[d] = 1.0;
+    }
+    run.region(lower, upper, calls);
+
+    std::vector<double> leaves(run.leafSums.size());
+    MPI_Allreduce(run.leafSums.data(), leaves.data(), static_cast<int>(leaves.size()), MPI_DOUBLE, MPI_SUM, comm);
+
+    const double volume = std::pow(b - a, Func::dims);
+    double estimate = 0.0, variance = 0.0, leafCalls = 0.0;
+    for (size_t leaf = 0; leaf < run.leafVolumes.size(); ++leaf) {
+        double n = leaves[3 * leaf + 2];
+        double mean = leaves[3 * leaf] / n;
+        double spread = std::max(0.0, leaves[3 * leaf + 1] / n - mean * mean) / (n - 1.0);
+        double v = run.leafVolumes[leaf];
+        estimate += v * mean;
+        variance += v * v * spread;
+        leafCalls += n;
+    }
+
+    MultiDimResult result;
+    result.estimate = volume * estimate;
+    result.stdError = volume * std::sqrt(variance);
+    result.chi2PerDof = 0.0;
+    result.calls = leafCalls + run.presampleCalls;
+    return result;
+}
+
+#endif // VEGAS_MISER_H